@@ -234,6 +234,8 @@ struct svm_model *matlab_matrix_to_model(const mxArray *matlab_struct, const cha
 	model->probB = NULL;
 	model->label = NULL;
 	model->sv_indices = NULL;
+	model->w = NULL;
+	model->w_dim = 0;
 	model->nSV = NULL;
 	model->free_sv = 1; // XXX
 
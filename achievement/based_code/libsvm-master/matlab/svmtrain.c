@@ -48,6 +48,9 @@ void exit_with_help()
 	"-b probability_estimates : whether to train a SVC or SVR model for probability estimates, 0 or 1 (default 0)\n"
 	"-wi weight : set the parameter C of class i to weight*C, for C-SVC (default 1)\n"
 	"-v n : n-fold cross validation mode\n"
+	"-j nr_thread : set the number of threads for kernel evaluation and cross validation folds (default 0, the OpenMP default)\n"
+	"-f single_precision : whether to evaluate kernels in single precision with SIMD, 0 or 1 (default 0)\n"
+	"-o active_cache_size : prefetch the active instances of at most this size in MB for out-of-core training (default 0)\n"
 	"-q : quiet mode (no outputs)\n"
 	);
 }
@@ -128,6 +131,9 @@ int parse_command_line(int nrhs, const mxArray *prhs[], char *model_file_name)
 	param.nr_weight = 0;
 	param.weight_label = NULL;
 	param.weight = NULL;
+	param.nr_thread = 0;
+	param.single_precision = 0;
+	param.active_cache_size = 0;
 	cross_validation = 0;
 
 	if(nrhs <= 1)
@@ -187,6 +193,15 @@ int parse_command_line(int nrhs, const mxArray *prhs[], char *model_file_name)
 			case 'b':
 				param.probability = atoi(argv[i]);
 				break;
+			case 'j':
+				param.nr_thread = atoi(argv[i]);
+				break;
+			case 'f':
+				param.single_precision = atoi(argv[i]);
+				break;
+			case 'o':
+				param.active_cache_size = atof(argv[i]);
+				break;
 			case 'q':
 				print_func = &print_null;
 				i--;
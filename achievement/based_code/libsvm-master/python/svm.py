@@ -19,7 +19,7 @@ try:
 	if sys.platform == 'win32':
 		libsvm = CDLL(path.join(dirname, r'..\windows\libsvm.dll'))
 	else:
-		libsvm = CDLL(path.join(dirname, '../libsvm.so.2'))
+		libsvm = CDLL(path.join(dirname, '../libsvm.so.3'))
 except:
 # For unix the prefix 'lib' is not considered.
 	if find_library('svm'):
@@ -114,10 +114,12 @@ class svm_problem(Structure):
 class svm_parameter(Structure):
 	_names = ["svm_type", "kernel_type", "degree", "gamma", "coef0",
 			"cache_size", "eps", "C", "nr_weight", "weight_label", "weight",
-			"nu", "p", "shrinking", "probability"]
+			"nu", "p", "shrinking", "probability", "nr_thread", "single_precision",
+			"active_cache_size"]
 	_types = [c_int, c_int, c_int, c_double, c_double,
 			c_double, c_double, c_double, c_int, POINTER(c_int), POINTER(c_double),
-			c_double, c_double, c_int, c_int]
+			c_double, c_double, c_int, c_int, c_int, c_int,
+			c_double]
 	_fields_ = genFields(_names, _types)
 
 	def __init__(self, options = None):
@@ -148,6 +150,9 @@ class svm_parameter(Structure):
 		self.p = 0.1
 		self.shrinking = 1
 		self.probability = 0
+		self.nr_thread = 0
+		self.single_precision = 0
+		self.active_cache_size = 0
 		self.nr_weight = 0
 		self.weight_label = None
 		self.weight = None
@@ -205,6 +210,15 @@ class svm_parameter(Structure):
 			elif argv[i] == "-b":
 				i = i + 1
 				self.probability = int(argv[i])
+			elif argv[i] == "-j":
+				i = i + 1
+				self.nr_thread = int(argv[i])
+			elif argv[i] == "-f":
+				i = i + 1
+				self.single_precision = int(argv[i])
+			elif argv[i] == "-o":
+				i = i + 1
+				self.active_cache_size = float(argv[i])
 			elif argv[i] == "-q":
 				self.print_func = PRINT_STRING_FUN(print_null)
 			elif argv[i] == "-v":
@@ -231,11 +245,12 @@ class svm_parameter(Structure):
 
 class svm_model(Structure):
 	_names = ['param', 'nr_class', 'l', 'SV', 'sv_coef', 'rho',
-			'probA', 'probB', 'sv_indices', 'label', 'nSV', 'free_sv']
+			'probA', 'probB', 'sv_indices', 'label', 'nSV', 'free_sv', 'w', 'w_dim']
 	_types = [svm_parameter, c_int, c_int, POINTER(POINTER(svm_node)),
 			POINTER(POINTER(c_double)), POINTER(c_double),
 			POINTER(c_double), POINTER(c_double), POINTER(c_int),
-			POINTER(c_int), POINTER(c_int), c_int]
+			POINTER(c_int), POINTER(c_int), c_int,
+			POINTER(POINTER(c_double)), c_int]
 	_fields_ = genFields(_names, _types)
 
 	def __init__(self):
@@ -305,10 +320,21 @@ def toPyModel(model_ptr):
 	return m
 
 fillprototype(libsvm.svm_train, POINTER(svm_model), [POINTER(svm_problem), POINTER(svm_parameter)])
+fillprototype(libsvm.svm_create_kernel_cache, c_void_p, [POINTER(svm_problem), POINTER(svm_parameter)])
+fillprototype(libsvm.svm_destroy_kernel_cache, None, [c_void_p])
+fillprototype(libsvm.svm_train_warm, POINTER(svm_model), [POINTER(svm_problem), POINTER(svm_parameter), POINTER(svm_model), c_void_p])
 fillprototype(libsvm.svm_cross_validation, None, [POINTER(svm_problem), POINTER(svm_parameter), c_int, POINTER(c_double)])
+fillprototype(libsvm.svm_cross_validation_path, None, [POINTER(svm_problem), POINTER(svm_parameter), c_int, c_int, POINTER(c_double), POINTER(c_double)])
+fillprototype(libsvm.svm_cross_validation_grid, None, [POINTER(svm_problem), POINTER(svm_parameter), c_int, c_int, POINTER(c_double), c_int, POINTER(c_double), POINTER(c_double)])
+fillprototype(libsvm.svm_train_cross_validation, POINTER(svm_model), [POINTER(svm_problem), POINTER(svm_parameter), c_int, POINTER(c_double)])
+fillprototype(libsvm.svm_train_pu_bsvm, POINTER(svm_model), [POINTER(svm_problem), POINTER(svm_parameter), c_int, c_int, POINTER(c_double), c_int, POINTER(c_double), POINTER(c_double), POINTER(c_int)])
+fillprototype(libsvm.svm_train_pu_iterative, POINTER(svm_model), [POINTER(svm_problem), POINTER(svm_parameter), POINTER(c_double), POINTER(c_int)])
 
 fillprototype(libsvm.svm_save_model, c_int, [c_char_p, POINTER(svm_model)])
 fillprototype(libsvm.svm_load_model, POINTER(svm_model), [c_char_p])
+fillprototype(libsvm.svm_save_model_binary, c_int, [c_char_p, POINTER(svm_model)])
+fillprototype(libsvm.svm_save_problem, c_int, [c_char_p, POINTER(svm_problem)])
+fillprototype(libsvm.svm_load_problem, POINTER(svm_problem), [c_char_p])
 
 fillprototype(libsvm.svm_get_svm_type, c_int, [POINTER(svm_model)])
 fillprototype(libsvm.svm_get_nr_class, c_int, [POINTER(svm_model)])
@@ -320,9 +346,13 @@ fillprototype(libsvm.svm_get_svr_probability, c_double, [POINTER(svm_model)])
 fillprototype(libsvm.svm_predict_values, c_double, [POINTER(svm_model), POINTER(svm_node), POINTER(c_double)])
 fillprototype(libsvm.svm_predict, c_double, [POINTER(svm_model), POINTER(svm_node)])
 fillprototype(libsvm.svm_predict_probability, c_double, [POINTER(svm_model), POINTER(svm_node), POINTER(c_double)])
+fillprototype(libsvm.svm_predict_values_batch, None, [POINTER(svm_model), c_int, POINTER(POINTER(svm_node)), POINTER(c_double), POINTER(c_double)])
+fillprototype(libsvm.svm_predict_batch, None, [POINTER(svm_model), c_int, POINTER(POINTER(svm_node)), POINTER(c_double)])
+fillprototype(libsvm.svm_predict_probability_batch, None, [POINTER(svm_model), c_int, POINTER(POINTER(svm_node)), POINTER(c_double), POINTER(c_double)])
 
 fillprototype(libsvm.svm_free_model_content, None, [POINTER(svm_model)])
 fillprototype(libsvm.svm_free_and_destroy_model, None, [POINTER(POINTER(svm_model))])
+fillprototype(libsvm.svm_free_and_destroy_problem, None, [POINTER(POINTER(svm_problem))])
 fillprototype(libsvm.svm_destroy_param, None, [POINTER(svm_parameter)])
 
 fillprototype(libsvm.svm_check_parameter, c_char_p, [POINTER(svm_problem), POINTER(svm_parameter)])
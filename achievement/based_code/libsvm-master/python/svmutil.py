@@ -118,6 +118,9 @@ def svm_train(arg1, arg2=None, arg3=None):
 	    -b probability_estimates : whether to train a SVC or SVR model for probability estimates, 0 or 1 (default 0)
 	    -wi weight : set the parameter C of class i to weight*C, for C-SVC (default 1)
 	    -v n: n-fold cross validation mode
+	    -j nr_thread : set the number of threads for kernel evaluation and cross validation folds (default 0, the OpenMP default)
+	    -f single_precision : whether to evaluate kernels in single precision with SIMD, 0 or 1 (default 0)
+	    -o active_cache_size : prefetch the active instances of at most this size in MB for out-of-core training (default 0)
 	    -q : quiet mode (no outputs)
 	"""
 	prob, param = None, None
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "svm.h"
+#include "svm-read.h"
+
+void exit_with_help()
+{
+	printf(
+	"Usage: svm-convert [options] input_file output_file\n"
+	"options:\n"
+	"-m : input_file is a model file (default: a data file)\n"
+	"-t : write the text format (default: the binary format)\n"
+	"input_file may be in either format.\n"
+	);
+	exit(1);
+}
+
+void exit_input_error(int line_num)
+{
+	fprintf(stderr,"Wrong input format at line %d\n", line_num);
+	exit(1);
+}
+
+void convert_model(const char *input_file_name, const char *output_file_name, int text)
+{
+	struct svm_model *model = svm_load_model(input_file_name);
+	int ret;
+
+	if(model == NULL)
+	{
+		fprintf(stderr,"can't open model file %s\n",input_file_name);
+		exit(1);
+	}
+	if(text)
+		ret = svm_save_model(output_file_name,model);
+	else
+		ret = svm_save_model_binary(output_file_name,model);
+	if(ret != 0)
+	{
+		fprintf(stderr,"can't save model to file %s\n",output_file_name);
+		exit(1);
+	}
+	svm_free_and_destroy_model(&model);
+}
+
+int save_problem_text(const char *filename, const struct svm_problem *prob)
+{
+	int i;
+	FILE *fp = fopen(filename,"w");
+	if(fp == NULL)
+		return -1;
+	for(i=0;i<prob->l;i++)
+	{
+		const struct svm_node *x = prob->x[i];
+		fprintf(fp,"%.17g",prob->y[i]);
+		for(;x->index != -1;x++)
+			fprintf(fp," %d:%.17g",x->index,x->value);
+		fprintf(fp,"\n");
+	}
+	if(ferror(fp) != 0 || fclose(fp) != 0)
+		return -1;
+	return 0;
+}
+
+void convert_problem(const char *input_file_name, const char *output_file_name, int text)
+{
+	struct svm_problem *binary_prob;
+	struct svm_data data;
+	int ret, error_line;
+
+	error_line = svm_read_problem(input_file_name,0,&data,&binary_prob);
+	if(error_line < 0)
+	{
+		fprintf(stderr,"can't open input file %s\n",input_file_name);
+		exit(1);
+	}
+	if(error_line > 0)
+		exit_input_error(error_line);
+
+	if(text)
+		ret = save_problem_text(output_file_name,&data.prob);
+	else
+		ret = svm_save_problem(output_file_name,&data.prob);
+	if(ret != 0)
+	{
+		fprintf(stderr,"can't save data to file %s\n",output_file_name);
+		exit(1);
+	}
+	if(binary_prob)
+		svm_free_and_destroy_problem(&binary_prob);
+	else
+		svm_free_data(&data);
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+	int is_model = 0, text = 0;
+
+	for(i=1;i<argc;i++)
+	{
+		if(argv[i][0] != '-') break;
+		switch(argv[i][1])
+		{
+			case 'm':
+				is_model = 1;
+				break;
+			case 't':
+				text = 1;
+				break;
+			default:
+				fprintf(stderr,"Unknown option: -%c\n", argv[i][1]);
+				exit_with_help();
+		}
+	}
+
+	if(i != argc-2)
+		exit_with_help();
+
+	if(is_model)
+		convert_model(argv[i],argv[i+1],text);
+	else
+		convert_problem(argv[i],argv[i+1],text);
+	return 0;
+}
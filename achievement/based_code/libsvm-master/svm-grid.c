@@ -0,0 +1,702 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include "svm.h"
+#include "svm-read.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#define Malloc(type,n) (type *)malloc((n)*sizeof(type))
+
+void print_null(const char *s) {}
+
+void exit_with_help()
+{
+	printf(
+	"Usage: svm-grid [grid_options] [svm_options] dataset\n"
+	"grid_options :\n"
+	"-log2c {begin,end,step | \"null\"} : set the range of c (default -5,15,2)\n"
+	"    begin,end,step -- c_range = 2^{begin,...,begin+k*step,...,end}\n"
+	"    \"null\"         -- do not grid with c\n"
+	"-log2g {begin,end,step | \"null\"} : set the range of g (default 3,-15,-2)\n"
+	"    begin,end,step -- g_range = 2^{begin,...,begin+k*step,...,end}\n"
+	"    \"null\"         -- do not grid with g\n"
+	"-v n : n-fold cross validation (default 5)\n"
+	"-gnuplot {pathname | \"null\"} :\n"
+	"    pathname -- set gnuplot executable path and name\n"
+	"    \"null\"   -- do not plot \n"
+	"-out {pathname | \"null\"} : (default dataset.out)\n"
+	"    pathname -- set output file path and name\n"
+	"    \"null\"   -- do not output file\n"
+	"-png pathname : set graphic output file path and name (default dataset.png)\n"
+	"svm_options : additional options for svm-train (-c and -g are set by the grid)\n"
+	);
+	exit(1);
+}
+
+void exit_input_error(int line_num)
+{
+	fprintf(stderr,"Wrong input format at line %d\n", line_num);
+	exit(1);
+}
+
+void parse_command_line(int argc, char **argv, char *input_file_name);
+void read_problem(const char *filename);
+void do_grid();
+
+struct svm_parameter param;		// set by parse_command_line
+struct svm_problem prob;		// set by read_problem
+struct svm_data data;			// set by read_problem
+struct svm_problem *binary_prob;	// set by read_problem for a binary data file
+int nr_fold;
+
+// grid_options, with the same defaults as tools/grid.py
+struct grid_range
+{
+	int enabled;
+	int is_float;	// given on the command line; grid.py then prints x.0
+	double begin, end, step;
+};
+struct grid_range c_range, g_range;
+char dataset_title[1024];
+char out_file_name[1024];	// empty for no output file
+char png_file_name[1024];
+char gnuplot_name[1024];	// empty for no plot
+
+int main(int argc, char **argv)
+{
+	char input_file_name[1024];
+	const char *error_msg;
+
+	parse_command_line(argc, argv, input_file_name);
+	read_problem(input_file_name);
+	error_msg = svm_check_parameter(&prob,&param);
+
+	if(error_msg)
+	{
+		fprintf(stderr,"ERROR: %s\n",error_msg);
+		exit(1);
+	}
+
+	do_grid();
+
+	svm_destroy_param(&param);
+	if(binary_prob)
+		svm_free_and_destroy_problem(&binary_prob);
+	else
+		svm_free_data(&data);
+
+	return 0;
+}
+
+// str() of a Python float: the shortest representation that reads back
+// as v, so that the output matches that of grid.py
+static void float_str(double v, int is_float, char *buf)
+{
+	char digits[32], *p;
+	int precision, exponent, nr_digit, i;
+
+	if(!is_float)
+	{
+		sprintf(buf,"%.0f",v);
+		return;
+	}
+	for(precision=1;precision<17;precision++)
+	{
+		sprintf(digits,"%.*e",precision-1,v);
+		if(strtod(digits,NULL) == v)
+			break;
+	}
+	sprintf(digits,"%.*e",precision-1,v);
+
+	p = strchr(digits,'e');
+	exponent = atoi(p+1);
+	*p = '\0';
+	// digits is now [-]d[.ddd]; remove the sign and the point
+	if(v < 0)
+		*buf++ = '-';
+	p = digits + (v < 0);
+	nr_digit = 0;
+	for(i=0;p[i];i++)
+		if(isdigit(p[i]))
+			p[nr_digit++] = p[i];
+	p[nr_digit] = '\0';
+
+	if(exponent < -4 || exponent >= 16)
+	{
+		if(nr_digit == 1)
+			sprintf(buf,"%ce%+03d",p[0],exponent);
+		else
+			sprintf(buf,"%c.%se%+03d",p[0],p+1,exponent);
+	}
+	else if(exponent < 0)
+	{
+		buf += sprintf(buf,"0.");
+		for(i=0;i<-exponent-1;i++)
+			*buf++ = '0';
+		sprintf(buf,"%s",p);
+	}
+	else
+	{
+		for(i=0;i<=exponent;i++)
+			*buf++ = (i < nr_digit)? p[i] : '0';
+		*buf++ = '.';
+		if(nr_digit > exponent+1)
+			sprintf(buf,"%s",p+exponent+1);
+		else
+			sprintf(buf,"0");
+	}
+}
+
+// begin, begin+step, ... up to end, as range_f in grid.py
+static int range_seq(const struct grid_range *r, double *seq)
+{
+	int n = 0;
+	double v = r->begin;
+	while(!((r->step > 0 && v > r->end) || (r->step < 0 && v < r->end)))
+	{
+		if(seq)
+			seq[n] = v;
+		++n;
+		v = v + r->step;
+	}
+	return n;
+}
+
+// the order of permute_sequence in grid.py: middle first, then the
+// middles of both halves alternately
+static void permute_sequence(const double *seq, int n, double *out)
+{
+	int mid = n/2;
+	int nl, nr, il = 0, ir = 0, k = 0;
+	double *left, *right;
+	if(n <= 1)
+	{
+		if(n == 1)
+			out[0] = seq[0];
+		return;
+	}
+	nl = mid;
+	nr = n-mid-1;
+	left = Malloc(double,n);
+	right = Malloc(double,n);
+	permute_sequence(seq,nl,left);
+	permute_sequence(seq+mid+1,nr,right);
+	out[k++] = seq[mid];
+	while(il < nl || ir < nr)
+	{
+		if(il < nl) out[k++] = left[il++];
+		if(ir < nr) out[k++] = right[ir++];
+	}
+	free(left);
+	free(right);
+}
+
+static int compare_double(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+	return (x < y)? -1 : (x > y)? 1 : 0;
+}
+
+// cross validation rate, formatted and parsed back as grid.py reads
+// the "%g%%" output of svm-train
+static double cv_rate(const double *target)
+{
+	char buf[64];
+	int i, total_correct = 0;
+	for(i=0;i<prob.l;i++)
+		if(target[i] == prob.y[i])
+			++total_correct;
+	sprintf(buf,"%g",100.0*total_correct/prob.l);
+	return strtod(buf,NULL);
+}
+
+struct grid_point
+{
+	double c, g, rate;
+};
+
+static void redraw(struct grid_point *db, int n, double best_c, double best_g, double best_rate)
+{
+	char buf1[64], buf2[64], buf3[64];
+	int i;
+	double max_rate = db[0].rate;
+	FILE *gnuplot;
+
+	for(i=1;i<n && db[i].c == db[0].c;i++);
+	if(i == n) return;
+	for(i=1;i<n && db[i].g == db[0].g;i++);
+	if(i == n) return;
+	for(i=1;i<n && db[i].rate == db[0].rate;i++);
+	if(i == n) return;
+
+	gnuplot = popen(gnuplot_name,"w");
+	if(gnuplot == NULL)
+	{
+		fprintf(stderr,"can't run %s\n",gnuplot_name);
+		return;
+	}
+	for(i=1;i<n;i++)
+		if(db[i].rate > max_rate)
+			max_rate = db[i].rate;
+
+	fprintf(gnuplot,"set term png transparent small linewidth 2 medium enhanced\n");
+	fprintf(gnuplot,"set output \"%s\"\n",png_file_name);
+	fprintf(gnuplot,"set xlabel \"log2(C)\"\n");
+	fprintf(gnuplot,"set ylabel \"log2(gamma)\"\n");
+	float_str(c_range.begin,c_range.is_float,buf1);
+	float_str(c_range.end,c_range.is_float,buf2);
+	fprintf(gnuplot,"set xrange [%s:%s]\n",buf1,buf2);
+	float_str(g_range.begin,g_range.is_float,buf1);
+	float_str(g_range.end,g_range.is_float,buf2);
+	fprintf(gnuplot,"set yrange [%s:%s]\n",buf1,buf2);
+	fprintf(gnuplot,"set contour\n");
+	fprintf(gnuplot,"set cntrparam levels incremental %.0f,0.5,100\n",rint(max_rate)-3);
+	fprintf(gnuplot,"unset surface\n");
+	fprintf(gnuplot,"unset ztics\n");
+	fprintf(gnuplot,"set view 0,0\n");
+	fprintf(gnuplot,"set title \"%s\"\n",dataset_title);
+	fprintf(gnuplot,"unset label\n");
+	float_str(best_c,c_range.is_float,buf1);
+	float_str(best_g,g_range.is_float,buf2);
+	float_str(best_rate,1,buf3);
+	fprintf(gnuplot,"set label \"Best log2(C) = %s  log2(gamma) = %s  accuracy = %s%%\" at screen 0.5,0.85 center\n",buf1,buf2,buf3);
+	float_str(pow(2.0,best_c),1,buf1);
+	float_str(pow(2.0,best_g),1,buf2);
+	fprintf(gnuplot,"set label \"C = %s  gamma = %s\" at screen 0.5,0.8 center\n",buf1,buf2);
+	fprintf(gnuplot,"set key at screen 0.9,0.9\n");
+	fprintf(gnuplot,"splot \"-\" with lines\n");
+	for(i=0;i<n;i++)
+	{
+		if(i > 0 && db[i].c != db[i-1].c)
+			fprintf(gnuplot,"\n");
+		float_str(db[i].c,c_range.is_float,buf1);
+		float_str(db[i].g,g_range.is_float,buf2);
+		float_str(db[i].rate,1,buf3);
+		fprintf(gnuplot,"%s %s %s\n",buf1,buf2,buf3);
+	}
+	fprintf(gnuplot,"e\n");
+	fprintf(gnuplot,"\n");
+	pclose(gnuplot);
+}
+
+static int compare_grid_point(const void *a, const void *b)
+{
+	const struct grid_point *p = (const struct grid_point *)a, *q = (const struct grid_point *)b;
+	if(p->c != q->c)
+		return (p->c < q->c)? -1 : 1;
+	if(p->g != q->g)
+		return (p->g > q->g)? -1 : 1;
+	return 0;
+}
+
+// Values of gamma are taken one batch at a time, in the order they are
+// needed, by svm_cross_validation_grid over all values of C. It trains
+// the pairs of a gamma and a fold of the batch in parallel, keeps the
+// kernel of each pair for all values of C and warm-starts each C from the
+// previous one. rand() is reset before each call as every svm-train run
+// of grid.py starts from the same seed, so all points use the same
+// folds; with probability estimates, which also draw from rand(), a batch
+// is a single gamma. Results are then reported in the order of grid.py.
+void do_grid()
+{
+	int i, j, k;
+	int nr_c = c_range.enabled? range_seq(&c_range,NULL) : 1;
+	int nr_g = g_range.enabled? range_seq(&g_range,NULL) : 1;
+	double *c_sorted = Malloc(double,nr_c), *c_seq = Malloc(double,nr_c);
+	double *g_sorted = Malloc(double,nr_g), *g_seq = Malloc(double,nr_g);
+	double *C = Malloc(double,nr_c);
+	double *rate = Malloc(double,nr_c*nr_g);	// rate[ci*nr_g+gi] in the order of c_seq, g_seq
+	int *done = Malloc(int,nr_g);
+	int batch = 1;
+	double *gamma, *target;
+	struct grid_point *db = Malloc(struct grid_point,nr_c*nr_g);
+	int nr_db = 0;
+	int best_c = -1, best_g = -1;
+	double best_rate = -1;
+	int ci = 0, gi = 0, next_g = 0;
+	FILE *out = NULL;
+	char buf1[64], buf2[64], buf3[64];
+
+	if(c_range.enabled)
+	{
+		range_seq(&c_range,c_sorted);
+		permute_sequence(c_sorted,nr_c,c_seq);
+	}
+	else
+		c_seq[0] = 0;
+	if(g_range.enabled)
+	{
+		range_seq(&g_range,g_sorted);
+		permute_sequence(g_sorted,nr_g,g_seq);
+	}
+	else
+		g_seq[0] = 0;
+	// C in increasing order for warm starts
+	memcpy(c_sorted,c_seq,sizeof(double)*nr_c);
+	qsort(c_sorted,nr_c,sizeof(double),compare_double);
+	for(i=0;i<nr_c;i++)
+		C[i] = c_range.enabled? pow(2.0,c_sorted[i]) : param.C;
+	for(j=0;j<nr_g;j++)
+		done[j] = 0;
+#ifdef _OPENMP
+	if(!param.probability)
+		batch = (param.nr_thread > 0)? param.nr_thread : omp_get_max_threads();
+#endif
+	batch = (batch < nr_g)? batch : nr_g;
+	gamma = Malloc(double,batch);
+	target = Malloc(double,(size_t)batch*nr_c*prob.l);
+
+	if(out_file_name[0])
+	{
+		out = fopen(out_file_name,"w");
+		if(out == NULL)
+		{
+			fprintf(stderr,"can't open output file %s\n",out_file_name);
+			exit(1);
+		}
+	}
+
+	// jobs of grid.py: lines alternately extend the C and gamma ranges
+	while(ci < nr_c || gi < nr_g)
+	{
+		int is_c_line = ((double)ci/nr_c < (double)gi/nr_g);
+		int n = is_c_line? gi : ci;
+		for(k=0;k<n;k++)
+		{
+			int pc = is_c_line? ci : k;
+			int pg = is_c_line? k : gi;
+			struct grid_point *p = &db[nr_db++];
+
+			// compute gamma rows in the order they are needed
+			while(!done[pg])
+			{
+				int nr_row = (nr_g-next_g < batch)? nr_g-next_g : batch;
+				int r;
+				for(r=0;r<nr_row;r++)
+					gamma[r] = g_range.enabled? pow(2.0,g_seq[next_g+r]) : param.gamma;
+				srand(1);
+				svm_cross_validation_grid(&prob,&param,nr_fold,nr_row,gamma,nr_c,C,target);
+				for(r=0;r<nr_row;r++,next_g++)
+				{
+					for(i=0;i<nr_c;i++)
+					{
+						int s;
+						for(s=0;c_sorted[s] != c_seq[i];s++);
+						rate[i*nr_g+next_g] = cv_rate(&target[((size_t)r*nr_c+s)*prob.l]);
+					}
+					done[next_g] = 1;
+				}
+			}
+
+			p->c = c_seq[pc];
+			p->g = g_seq[pg];
+			p->rate = rate[pc*nr_g+pg];
+			if(p->rate > best_rate || (p->rate == best_rate && pg == best_g && p->c < c_seq[best_c]))
+			{
+				best_rate = p->rate;
+				best_c = pc;
+				best_g = pg;
+			}
+
+			printf("[local]");
+			if(c_range.enabled)
+			{
+				float_str(p->c,c_range.is_float,buf1);
+				printf(" %s",buf1);
+			}
+			if(g_range.enabled)
+			{
+				float_str(p->g,g_range.is_float,buf1);
+				printf(" %s",buf1);
+			}
+			float_str(p->rate,1,buf3);
+			printf(" %s (best ",buf3);
+			if(c_range.enabled)
+			{
+				float_str(pow(2.0,c_seq[best_c]),1,buf1);
+				printf("c=%s, ",buf1);
+			}
+			if(g_range.enabled)
+			{
+				float_str(pow(2.0,g_seq[best_g]),1,buf2);
+				printf("g=%s, ",buf2);
+			}
+			float_str(best_rate,1,buf3);
+			printf("rate=%s)\n",buf3);
+			fflush(stdout);
+
+			if(out)
+			{
+				if(c_range.enabled)
+				{
+					float_str(p->c,c_range.is_float,buf1);
+					fprintf(out,"log2c=%s ",buf1);
+				}
+				if(g_range.enabled)
+				{
+					float_str(p->g,g_range.is_float,buf1);
+					fprintf(out,"log2g=%s ",buf1);
+				}
+				float_str(p->rate,1,buf3);
+				fprintf(out,"rate=%s\n",buf3);
+				fflush(out);
+			}
+		}
+		if(is_c_line)
+			++ci;
+		else
+			++gi;
+	}
+	if(out)
+		fclose(out);
+
+	if(gnuplot_name[0] && c_range.enabled && g_range.enabled && nr_db > 0)
+	{
+		qsort(db,nr_db,sizeof(struct grid_point),compare_grid_point);
+		redraw(db,nr_db,c_seq[best_c],g_seq[best_g],best_rate);
+	}
+
+	if(c_range.enabled)
+	{
+		float_str(pow(2.0,c_seq[best_c]),1,buf1);
+		printf("%s ",buf1);
+	}
+	if(g_range.enabled)
+	{
+		float_str(pow(2.0,g_seq[best_g]),1,buf2);
+		printf("%s ",buf2);
+	}
+	float_str(best_rate,1,buf3);
+	printf("%s\n",buf3);
+
+	free(c_sorted);
+	free(c_seq);
+	free(g_sorted);
+	free(g_seq);
+	free(C);
+	free(rate);
+	free(done);
+	free(gamma);
+	free(target);
+	free(db);
+}
+
+static void parse_range(const char *s, struct grid_range *r)
+{
+	if(strcmp(s,"null") == 0)
+	{
+		r->enabled = 0;
+		return;
+	}
+	if(sscanf(s,"%lf,%lf,%lf",&r->begin,&r->end,&r->step) != 3 || r->step == 0)
+	{
+		fprintf(stderr,"Wrong range: %s\n",s);
+		exit_with_help();
+	}
+	r->enabled = 1;
+	r->is_float = 1;
+}
+
+void parse_command_line(int argc, char **argv, char *input_file_name)
+{
+	int i;
+	char *p;
+
+	// default values
+	param.svm_type = C_SVC;
+	param.kernel_type = RBF;
+	param.degree = 3;
+	param.gamma = 0;	// 1/num_features
+	param.coef0 = 0;
+	param.nu = 0.5;
+	param.cache_size = 100;
+	param.C = 1;
+	param.eps = 1e-3;
+	param.p = 0.1;
+	param.shrinking = 1;
+	param.probability = 0;
+	param.nr_weight = 0;
+	param.weight_label = NULL;
+	param.weight = NULL;
+	param.nr_thread = 0;
+	param.single_precision = 0;
+	param.active_cache_size = 0;
+	nr_fold = 5;
+	c_range.enabled = 1; c_range.is_float = 0;
+	c_range.begin = -5; c_range.end = 15; c_range.step = 2;
+	g_range.enabled = 1; g_range.is_float = 0;
+	g_range.begin = 3; g_range.end = -15; g_range.step = -2;
+	strcpy(gnuplot_name,"/usr/bin/gnuplot");
+	out_file_name[0] = '\0';
+	png_file_name[0] = '\0';
+	svm_set_print_string_function(&print_null);
+
+	// parse options
+	for(i=1;i<argc-1;i++)
+	{
+		if(argv[i][0] != '-') break;
+		if(strcmp(argv[i],"-log2c") == 0)
+			parse_range(argv[++i],&c_range);
+		else if(strcmp(argv[i],"-log2g") == 0)
+			parse_range(argv[++i],&g_range);
+		else if(strcmp(argv[i],"-gnuplot") == 0)
+		{
+			++i;
+			if(strcmp(argv[i],"null") == 0)
+				gnuplot_name[0] = '\0';
+			else
+				strcpy(gnuplot_name,argv[i]);
+		}
+		else if(strcmp(argv[i],"-out") == 0)
+		{
+			++i;
+			if(strcmp(argv[i],"null") == 0)
+				strcpy(out_file_name,"null");
+			else
+				strcpy(out_file_name,argv[i]);
+		}
+		else if(strcmp(argv[i],"-png") == 0)
+			strcpy(png_file_name,argv[++i]);
+		else if(strcmp(argv[i],"-q") == 0)
+			continue;
+		else
+		{
+			if(++i>=argc-1)
+				exit_with_help();
+			switch(argv[i-1][1])
+			{
+				case 's':
+					param.svm_type = atoi(argv[i]);
+					break;
+				case 't':
+					param.kernel_type = atoi(argv[i]);
+					break;
+				case 'd':
+					param.degree = atoi(argv[i]);
+					break;
+				case 'r':
+					param.coef0 = atof(argv[i]);
+					break;
+				case 'n':
+					param.nu = atof(argv[i]);
+					break;
+				case 'm':
+					param.cache_size = atof(argv[i]);
+					break;
+				case 'e':
+					param.eps = atof(argv[i]);
+					break;
+				case 'p':
+					param.p = atof(argv[i]);
+					break;
+				case 'h':
+					param.shrinking = atoi(argv[i]);
+					break;
+				case 'b':
+					param.probability = atoi(argv[i]);
+					break;
+				case 'j':
+					param.nr_thread = atoi(argv[i]);
+					break;
+				case 'f':
+					param.single_precision = atoi(argv[i]);
+					break;
+				case 'o':
+					param.active_cache_size = atof(argv[i]);
+					break;
+				case 'v':
+					nr_fold = atoi(argv[i]);
+					if(nr_fold < 2)
+					{
+						fprintf(stderr,"n-fold cross validation: n must >= 2\n");
+						exit_with_help();
+					}
+					break;
+				case 'w':
+					++param.nr_weight;
+					param.weight_label = (int *)realloc(param.weight_label,sizeof(int)*param.nr_weight);
+					param.weight = (double *)realloc(param.weight,sizeof(double)*param.nr_weight);
+					param.weight_label[param.nr_weight-1] = atoi(&argv[i-1][2]);
+					param.weight[param.nr_weight-1] = atof(argv[i]);
+					break;
+				case 'c':
+				case 'g':
+					fprintf(stderr,"Use -log2c and -log2g.\n");
+					exit_with_help();
+					break;
+				default:
+					fprintf(stderr,"Unknown option: -%c\n", argv[i-1][1]);
+					exit_with_help();
+			}
+		}
+	}
+
+	if(i>=argc)
+		exit_with_help();
+	if(!c_range.enabled && !g_range.enabled)
+	{
+		fprintf(stderr,"-log2c and -log2g should not be null simultaneously\n");
+		exit_with_help();
+	}
+	if(param.svm_type == EPSILON_SVR || param.svm_type == NU_SVR)
+	{
+		fprintf(stderr,"svm-grid searches classification accuracy; regression is not supported\n");
+		exit_with_help();
+	}
+
+	strcpy(input_file_name, argv[i]);
+	p = strrchr(argv[i],'/');
+	if(p==NULL)
+		p = argv[i];
+	else
+		++p;
+	strcpy(dataset_title,p);
+
+	if(strcmp(out_file_name,"null") == 0)
+		out_file_name[0] = '\0';
+	else if(out_file_name[0] == '\0')
+		sprintf(out_file_name,"%s.out",dataset_title);
+	if(png_file_name[0] == '\0')
+		sprintf(png_file_name,"%s.png",dataset_title);
+	if(gnuplot_name[0])
+	{
+		FILE *fp = fopen(gnuplot_name,"r");
+		if(fp == NULL)
+		{
+			fprintf(stderr,"gnuplot executable not found\n");
+			gnuplot_name[0] = '\0';
+		}
+		else
+			fclose(fp);
+	}
+}
+
+// read in a problem (in svmlight format or the binary format of svm-convert)
+
+void read_problem(const char *filename)
+{
+	const char *error_msg;
+	int error_line = svm_read_problem(filename,param.nr_thread,&data,&binary_prob);
+
+	if(error_line < 0)
+	{
+		fprintf(stderr,"can't open input file %s\n",filename);
+		exit(1);
+	}
+	if(error_line > 0)
+		exit_input_error(error_line);
+	prob = data.prob;
+
+	if(param.gamma == 0 && data.max_index > 0)
+		param.gamma = 1.0/data.max_index;
+
+	if(param.kernel_type == PRECOMPUTED && (error_msg = svm_check_precomputed(&prob,data.max_index)) != NULL)
+	{
+		fprintf(stderr,"Wrong input format: %s\n",error_msg);
+		exit(1);
+	}
+}
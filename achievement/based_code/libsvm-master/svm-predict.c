@@ -4,37 +4,16 @@
 #include <string.h>
 #include <errno.h>
 #include "svm.h"
+#include "svm-read.h"
 
 int print_null(const char *s,...) {return 0;}
 
 static int (*info)(const char *fmt,...) = &printf;
 
-struct svm_node *x;
-int max_nr_attr = 64;
-
 struct svm_model* model;
 int predict_probability=0;
-
-static char *line = NULL;
-static int max_line_len;
-
-static char* readline(FILE *input)
-{
-	int len;
-
-	if(fgets(line,max_line_len,input) == NULL)
-		return NULL;
-
-	while(strrchr(line,'\n') == NULL)
-	{
-		max_line_len *= 2;
-		line = (char *) realloc(line,max_line_len);
-		len = (int) strlen(line);
-		if(fgets(line+len,max_line_len-len,input) == NULL)
-			break;
-	}
-	return line;
-}
+int batch_size=1;
+int nr_thread=0;
 
 void exit_input_error(int line_num)
 {
@@ -42,7 +21,8 @@ void exit_input_error(int line_num)
 	exit(1);
 }
 
-void predict(FILE *input, FILE *output)
+// test instances come from input, or from binary_prob if input is NULL
+void predict(struct svm_reader *input, const struct svm_problem *binary_prob, FILE *output)
 {
 	int correct = 0;
 	int total = 0;
@@ -54,6 +34,10 @@ void predict(FILE *input, FILE *output)
 	double *prob_estimates=NULL;
 	int j;
 
+	struct svm_data data;
+	double *predict_label = (double *) malloc(batch_size*sizeof(double));
+	int predict_prob = predict_probability && (svm_type==C_SVC || svm_type==NU_SVC);
+
 	if(predict_probability)
 	{
 		if (svm_type==NU_SVR || svm_type==EPSILON_SVR)
@@ -62,7 +46,7 @@ void predict(FILE *input, FILE *output)
 		{
 			int *labels=(int *) malloc(nr_class*sizeof(int));
 			svm_get_labels(model,labels);
-			prob_estimates = (double *) malloc(nr_class*sizeof(double));
+			prob_estimates = (double *) malloc(batch_size*nr_class*sizeof(double));
 			fprintf(output,"labels");		
 			for(j=0;j<nr_class;j++)
 				fprintf(output," %d",labels[j]);
@@ -71,75 +55,68 @@ void predict(FILE *input, FILE *output)
 		}
 	}
 
-	max_line_len = 1024;
-	line = (char *)malloc(max_line_len*sizeof(char));
-	while(readline(input) != NULL)
+	// a text test file is parsed a block at a time and each block is
+	// predicted in batches of batch_size instances
+	memset(&data,0,sizeof(data));
+	while(1)
 	{
-		int i = 0;
-		double target_label, predict_label;
-		char *idx, *val, *label, *endptr;
-		int inst_max_index = -1; // strtol gives 0 if wrong format, and precomputed kernel has <index> start from 0
-
-		label = strtok(line," \t\n");
-		if(label == NULL) // empty line
-			exit_input_error(total+1);
-
-		target_label = strtod(label,&endptr);
-		if(endptr == label || *endptr != '\0')
-			exit_input_error(total+1);
+		int start;
+		const struct svm_problem *prob = binary_prob;
+		if(input != NULL)
+		{
+			int error_line = svm_read_next(input,SVM_READ_BLOCK_SIZE,nr_thread,&data);
+			if(error_line != 0)
+				exit_input_error(error_line);
+			prob = &data.prob;
+		}
+		if(prob->l == 0)
+			break;
 
-		while(1)
+		for(start=0;start<prob->l;start+=batch_size)
 		{
-			if(i>=max_nr_attr-1)	// need one more for index = -1
+			int b;
+			int nr_batch = (prob->l-start < batch_size)? prob->l-start : batch_size;
+			struct svm_node **x_batch = &prob->x[start];
+			const double *target_label = &prob->y[start];
+
+			if(batch_size == 1)
 			{
-				max_nr_attr *= 2;
-				x = (struct svm_node *) realloc(x,max_nr_attr*sizeof(struct svm_node));
+				if(predict_prob)
+					predict_label[0] = svm_predict_probability(model,x_batch[0],prob_estimates);
+				else
+					predict_label[0] = svm_predict(model,x_batch[0]);
 			}
-
-			idx = strtok(NULL,":");
-			val = strtok(NULL," \t");
-
-			if(val == NULL)
-				break;
-			errno = 0;
-			x[i].index = (int) strtol(idx,&endptr,10);
-			if(endptr == idx || errno != 0 || *endptr != '\0' || x[i].index <= inst_max_index)
-				exit_input_error(total+1);
+			else if(predict_prob)
+				svm_predict_probability_batch(model,nr_batch,x_batch,prob_estimates,predict_label);
 			else
-				inst_max_index = x[i].index;
-
-			errno = 0;
-			x[i].value = strtod(val,&endptr);
-			if(endptr == val || errno != 0 || (*endptr != '\0' && !isspace(*endptr)))
-				exit_input_error(total+1);
-
-			++i;
-		}
-		x[i].index = -1;
+				svm_predict_batch(model,nr_batch,x_batch,predict_label);
 
-		if (predict_probability && (svm_type==C_SVC || svm_type==NU_SVC))
-		{
-			predict_label = svm_predict_probability(model,x,prob_estimates);
-			fprintf(output,"%g",predict_label);
-			for(j=0;j<nr_class;j++)
-				fprintf(output," %g",prob_estimates[j]);
-			fprintf(output,"\n");
-		}
-		else
-		{
-			predict_label = svm_predict(model,x);
-			fprintf(output,"%g\n",predict_label);
+			for(b=0;b<nr_batch;b++)
+			{
+				double p = predict_label[b], t = target_label[b];
+				if(predict_prob)
+				{
+					fprintf(output,"%g",p);
+					for(j=0;j<nr_class;j++)
+						fprintf(output," %g",prob_estimates[b*nr_class+j]);
+					fprintf(output,"\n");
+				}
+				else
+					fprintf(output,"%g\n",p);
+
+				if(p == t)
+					++correct;
+				error += (p-t)*(p-t);
+				sump += p;
+				sumt += t;
+				sumpp += p*p;
+				sumtt += t*t;
+				sumpt += p*t;
+				++total;
+			}
 		}
-
-		if(predict_label == target_label)
-			++correct;
-		error += (predict_label-target_label)*(predict_label-target_label);
-		sump += predict_label;
-		sumt += target_label;
-		sumpp += predict_label*predict_label;
-		sumtt += target_label*target_label;
-		sumpt += predict_label*target_label;
-		++total;
+		if(input == NULL)
+			break;
 	}
 	if (svm_type==NU_SVR || svm_type==EPSILON_SVR)
 	{
@@ -154,6 +131,8 @@ void predict(FILE *input, FILE *output)
 			(double)correct/total*100,correct,total);
 	if(predict_probability)
 		free(prob_estimates);
+	svm_free_data(&data);
+	free(predict_label);
 }
 
 void exit_with_help()
@@ -162,6 +141,8 @@ void exit_with_help()
 	"Usage: svm-predict [options] test_file model_file output_file\n"
 	"options:\n"
 	"-b probability_estimates: whether to predict probability estimates, 0 or 1 (default 0); for one-class SVM only 0 is supported\n"
+	"-n batch_size : predict batch_size instances at a time with the batch interface (default 1)\n"
+	"-j nr_thread : set the number of threads for batch prediction (default 0, the OpenMP default)\n"
 	"-q : quiet mode (no outputs)\n"
 	);
 	exit(1);
@@ -169,7 +150,9 @@ void exit_with_help()
 
 int main(int argc, char **argv)
 {
-	FILE *input, *output;
+	struct svm_reader *input = NULL;
+	struct svm_problem *binary_prob;
+	FILE *output;
 	int i;
 	// parse options
 	for(i=1;i<argc;i++)
@@ -181,6 +164,17 @@ int main(int argc, char **argv)
 			case 'b':
 				predict_probability = atoi(argv[i]);
 				break;
+			case 'n':
+				batch_size = atoi(argv[i]);
+				if(batch_size < 1)
+				{
+					fprintf(stderr,"batch_size must >= 1\n");
+					exit_with_help();
+				}
+				break;
+			case 'j':
+				nr_thread = atoi(argv[i]);
+				break;
 			case 'q':
 				info = &print_null;
 				i--;
@@ -194,8 +188,10 @@ int main(int argc, char **argv)
 	if(i>=argc-2)
 		exit_with_help();
 
-	input = fopen(argv[i],"r");
-	if(input == NULL)
+	binary_prob = svm_load_problem(argv[i]);
+	if(binary_prob == NULL)
+		input = svm_open_reader(argv[i]);
+	if(binary_prob == NULL && input == NULL)
 	{
 		fprintf(stderr,"can't open input file %s\n",argv[i]);
 		exit(1);
@@ -213,8 +209,8 @@ int main(int argc, char **argv)
 		fprintf(stderr,"can't open model file %s\n",argv[i+1]);
 		exit(1);
 	}
+	model->param.nr_thread = nr_thread;
 
-	x = (struct svm_node *) malloc(max_nr_attr*sizeof(struct svm_node));
 	if(predict_probability)
 	{
 		if(svm_check_probability_model(model)==0)
@@ -229,11 +225,10 @@ int main(int argc, char **argv)
 			info("Model supports probability estimates, but disabled in prediction.\n");
 	}
 
-	predict(input,output);
+	predict(input,binary_prob,output);
 	svm_free_and_destroy_model(&model);
-	free(x);
-	free(line);
-	fclose(input);
+	svm_close_reader(input);
+	svm_free_and_destroy_problem(&binary_prob);
 	fclose(output);
 	return 0;
 }
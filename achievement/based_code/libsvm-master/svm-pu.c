@@ -0,0 +1,399 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "svm.h"
+#include "svm-read.h"
+#define Malloc(type,n) (type *)malloc((n)*sizeof(type))
+
+void print_null(const char *s) {}
+
+void exit_with_help()
+{
+	printf(
+	"Usage: svm-pu [options] positive_file unlabeled_file [model_file]\n"
+	"options:\n"
+	"-a algorithm : set PU learning algorithm (default 0)\n"
+	"	0 -- biased SVM\n"
+	"	1 -- iterative SVM\n"
+	"-log2cp begin,end,step : set the range of the cost of positives (default -3,7,2)\n"
+	"-log2cn begin,end,step : set the range of the cost of unlabeled (default -7,1,2)\n"
+	"-v n : n-fold cross validation to select the costs (default 5)\n"
+	"-c cost : set the cost C of the iterative SVM (default 1)\n"
+	"-w weight : set the cost of the positives to weight*C in the iterative SVM (default 1)\n"
+	"-t kernel_type : set type of kernel function (default 2)\n"
+	"	0 -- linear: u'*v\n"
+	"	1 -- polynomial: (gamma*u'*v + coef0)^degree\n"
+	"	2 -- radial basis function: exp(-gamma*|u-v|^2)\n"
+	"	3 -- sigmoid: tanh(gamma*u'*v + coef0)\n"
+	"-d degree : set degree in kernel function (default 3)\n"
+	"-g gamma : set gamma in kernel function (default 1/num_features)\n"
+	"-r coef0 : set coef0 in kernel function (default 0)\n"
+	"-m cachesize : set cache memory size in MB (default 100)\n"
+	"-e epsilon : set tolerance of termination criterion (default 0.001)\n"
+	"-h shrinking : whether to use the shrinking heuristics, 0 or 1 (default 1)\n"
+	"-j nr_thread : set number of OpenMP threads, 0 for the default (default 0)\n"
+	"-f single_precision : whether to compute kernels in single precision, 0 or 1 (default 0)\n"
+	"-o active_cache_size : prefetch active instances up to this size in MB (default 0)\n"
+	"-q : quiet mode (no outputs)\n"
+	);
+	exit(1);
+}
+
+void exit_input_error(const char *filename, int line_num)
+{
+	fprintf(stderr,"Wrong input format in %s at line %d\n", filename, line_num);
+	exit(1);
+}
+
+void parse_command_line(int argc, char **argv, char *positive_file_name, char *unlabeled_file_name, char *model_file_name);
+void read_problem(const char *positive_file_name, const char *unlabeled_file_name);
+void do_bsvm(const char *model_file_name);
+void do_iterative(const char *model_file_name);
+
+struct svm_parameter param;		// set by parse_command_line
+struct svm_problem prob;		// set by read_problem
+struct svm_problem *binary_prob[2];	// set by read_problem for binary data files
+struct svm_data data[2];
+int nr_positive;
+int algorithm;
+int nr_fold;
+int quiet;
+double positive_weight;
+
+struct cost_range
+{
+	double begin, end, step;
+};
+struct cost_range cp_range, cn_range;
+
+int main(int argc, char **argv)
+{
+	char positive_file_name[1024];
+	char unlabeled_file_name[1024];
+	char model_file_name[1024];
+	const char *error_msg;
+	int i;
+
+	parse_command_line(argc, argv, positive_file_name, unlabeled_file_name, model_file_name);
+	read_problem(positive_file_name, unlabeled_file_name);
+	error_msg = svm_check_parameter(&prob,&param);
+
+	if(error_msg)
+	{
+		fprintf(stderr,"ERROR: %s\n",error_msg);
+		exit(1);
+	}
+
+	switch(algorithm)
+	{
+		case 0:
+			do_bsvm(model_file_name);
+			break;
+		case 1:
+			do_iterative(model_file_name);
+			break;
+	}
+
+	svm_destroy_param(&param);
+	free(prob.y);
+	free(prob.x);
+	for(i=0;i<2;i++)
+	{
+		if(binary_prob[i])
+			svm_free_and_destroy_problem(&binary_prob[i]);
+		else
+			svm_free_data(&data[i]);
+	}
+
+	return 0;
+}
+
+// 2^begin, 2^(begin+step), ... up to 2^end
+static int range_seq(const struct cost_range *r, double *seq)
+{
+	int n = 0;
+	double v = r->begin;
+	while(!((r->step > 0 && v > r->end) || (r->step < 0 && v < r->end)))
+	{
+		if(seq)
+			seq[n] = pow(2.0,v);
+		++n;
+		v = v + r->step;
+	}
+	return n;
+}
+
+// The whole (Cp, Cn) grid is one call of svm_train_pu_bsvm, which
+// shares one kernel cache over all folds and costs and warm-starts
+// each point from its neighbour.
+void do_bsvm(const char *model_file_name)
+{
+	int nr_Cp = range_seq(&cp_range,NULL);
+	int nr_Cn = range_seq(&cn_range,NULL);
+	double *Cp = Malloc(double,nr_Cp);
+	double *Cn = Malloc(double,nr_Cn);
+	double *score = Malloc(double,nr_Cp*nr_Cn);
+	int best, i, j;
+	struct svm_model *model;
+
+	if(nr_Cp <= 0 || nr_Cn <= 0)
+	{
+		fprintf(stderr,"empty cost range\n");
+		exit(1);
+	}
+	range_seq(&cp_range,Cp);
+	range_seq(&cn_range,Cn);
+
+	model = svm_train_pu_bsvm(&prob,&param,nr_fold,nr_Cp,Cp,nr_Cn,Cn,score,&best);
+
+	if(!quiet)
+	{
+		for(j=0;j<nr_Cn;j++)
+			for(i=0;i<nr_Cp;i++)
+				printf("log2cp=%g log2cn=%g score=%g\n",
+					log(Cp[i])/log(2.0),log(Cn[j])/log(2.0),score[j*nr_Cp+i]);
+	}
+	printf("Best Cp = %g Cn = %g score = %g\n",Cp[best%nr_Cp],Cn[best/nr_Cp],score[best]);
+
+	if(svm_save_model(model_file_name,model))
+	{
+		fprintf(stderr, "can't save model to file %s\n", model_file_name);
+		exit(1);
+	}
+	svm_free_and_destroy_model(&model);
+	free(Cp);
+	free(Cn);
+	free(score);
+}
+
+// All unlabeled instances start in the remainder Q, so that the first
+// reliable negatives are those predicted negative by the positives
+// against all of Q.
+void do_iterative(const char *model_file_name)
+{
+	int weight_label[1] = {+1};
+	double weight[1];
+	double *label = Malloc(double,prob.l);
+	int nr_iter, nr_rn = 0, i;
+	struct svm_model *model;
+
+	for(i=0;i<prob.l;i++)
+		if(prob.y[i] < 0)
+			prob.y[i] = 0;
+	weight[0] = positive_weight;
+	param.nr_weight = 1;
+	param.weight_label = weight_label;
+	param.weight = weight;
+	model = svm_train_pu_iterative(&prob,&param,label,&nr_iter);
+	param.nr_weight = 0;
+	param.weight_label = NULL;
+	param.weight = NULL;
+
+	for(i=0;i<prob.l;i++)
+		if(label[i] < 0)
+			++nr_rn;
+	printf("Rounds = %d reliable negatives = %d unlabeled left = %d\n",
+		nr_iter,nr_rn,prob.l-nr_rn-nr_positive);
+
+	if(svm_save_model(model_file_name,model))
+	{
+		fprintf(stderr, "can't save model to file %s\n", model_file_name);
+		exit(1);
+	}
+	svm_free_and_destroy_model(&model);
+	free(label);
+}
+
+static void parse_range(const char *s, struct cost_range *r)
+{
+	if(sscanf(s,"%lf,%lf,%lf",&r->begin,&r->end,&r->step) != 3 || r->step == 0)
+	{
+		fprintf(stderr,"Wrong range: %s\n",s);
+		exit_with_help();
+	}
+}
+
+void parse_command_line(int argc, char **argv, char *positive_file_name, char *unlabeled_file_name, char *model_file_name)
+{
+	int i;
+	char *p;
+
+	// default values
+	param.svm_type = C_SVC;
+	param.kernel_type = RBF;
+	param.degree = 3;
+	param.gamma = 0;	// 1/num_features
+	param.coef0 = 0;
+	param.nu = 0.5;
+	param.cache_size = 100;
+	param.C = 1;
+	param.eps = 1e-3;
+	param.p = 0.1;
+	param.shrinking = 1;
+	param.probability = 0;
+	param.nr_weight = 0;
+	param.weight_label = NULL;
+	param.weight = NULL;
+	param.nr_thread = 0;
+	param.single_precision = 0;
+	param.active_cache_size = 0;
+	algorithm = 0;
+	nr_fold = 5;
+	quiet = 0;
+	positive_weight = 1;
+	cp_range.begin = -3; cp_range.end = 7; cp_range.step = 2;
+	cn_range.begin = -7; cn_range.end = 1; cn_range.step = 2;
+
+	// parse options
+	for(i=1;i<argc;i++)
+	{
+		if(argv[i][0] != '-') break;
+		if(strcmp(argv[i],"-log2cp") == 0 || strcmp(argv[i],"-log2cn") == 0)
+		{
+			if(++i>=argc)
+				exit_with_help();
+			parse_range(argv[i],(argv[i-1][6] == 'p')? &cp_range : &cn_range);
+			continue;
+		}
+		if(argv[i][1] == 'q')
+		{
+			svm_set_print_string_function(&print_null);
+			quiet = 1;
+			continue;
+		}
+		if(++i>=argc)
+			exit_with_help();
+		switch(argv[i-1][1])
+		{
+			case 'a':
+				algorithm = atoi(argv[i]);
+				break;
+			case 't':
+				param.kernel_type = atoi(argv[i]);
+				break;
+			case 'd':
+				param.degree = atoi(argv[i]);
+				break;
+			case 'g':
+				param.gamma = atof(argv[i]);
+				break;
+			case 'c':
+				param.C = atof(argv[i]);
+				break;
+			case 'w':
+				positive_weight = atof(argv[i]);
+				break;
+			case 'r':
+				param.coef0 = atof(argv[i]);
+				break;
+			case 'm':
+				param.cache_size = atof(argv[i]);
+				break;
+			case 'e':
+				param.eps = atof(argv[i]);
+				break;
+			case 'h':
+				param.shrinking = atoi(argv[i]);
+				break;
+			case 'j':
+				param.nr_thread = atoi(argv[i]);
+				break;
+			case 'f':
+				param.single_precision = atoi(argv[i]);
+				break;
+			case 'o':
+				param.active_cache_size = atof(argv[i]);
+				break;
+			case 'v':
+				nr_fold = atoi(argv[i]);
+				if(nr_fold < 2)
+				{
+					fprintf(stderr,"n-fold cross validation: n must >= 2\n");
+					exit_with_help();
+				}
+				break;
+			default:
+				fprintf(stderr,"Unknown option: -%c\n", argv[i-1][1]);
+				exit_with_help();
+		}
+	}
+
+	if(i>=argc-1)
+		exit_with_help();
+	if(algorithm != 0 && algorithm != 1)
+	{
+		fprintf(stderr,"Unknown algorithm: %d\n", algorithm);
+		exit_with_help();
+	}
+	if(param.kernel_type == PRECOMPUTED)
+	{
+		fprintf(stderr,"precomputed kernels are not supported\n");
+		exit_with_help();
+	}
+
+	strcpy(positive_file_name, argv[i]);
+	strcpy(unlabeled_file_name, argv[i+1]);
+
+	if(i<argc-2)
+		strcpy(model_file_name,argv[i+2]);
+	else
+	{
+		p = strrchr(argv[i],'/');
+		if(p==NULL)
+			p = argv[i];
+		else
+			++p;
+		sprintf(model_file_name,"%s.model",p);
+	}
+}
+
+// read one file (in svmlight format or the binary format of svm-convert)
+// into binary_prob[k] or data[k]; labels in the file are ignored
+static const struct svm_problem *read_file(const char *filename, int k, int *max_index)
+{
+	int error_line = svm_read_problem(filename,param.nr_thread,&data[k],&binary_prob[k]);
+
+	if(error_line < 0)
+	{
+		fprintf(stderr,"can't open input file %s\n",filename);
+		exit(1);
+	}
+	if(error_line > 0)
+		exit_input_error(filename,error_line);
+	if(data[k].max_index > *max_index)
+		*max_index = data[k].max_index;
+	return &data[k].prob;
+}
+
+// positives are labeled +1 and unlabeled instances -1; the instances
+// themselves are used in place
+void read_problem(const char *positive_file_name, const char *unlabeled_file_name)
+{
+	int max_index = 0, i;
+	const struct svm_problem *pos = read_file(positive_file_name,0,&max_index);
+	const struct svm_problem *unl = read_file(unlabeled_file_name,1,&max_index);
+
+	if(pos->l == 0 || unl->l == 0)
+	{
+		fprintf(stderr,"both the positive and the unlabeled files must be non-empty\n");
+		exit(1);
+	}
+	nr_positive = pos->l;
+	prob.l = pos->l+unl->l;
+	prob.y = Malloc(double,prob.l);
+	prob.x = Malloc(struct svm_node *,prob.l);
+	for(i=0;i<pos->l;i++)
+	{
+		prob.y[i] = +1;
+		prob.x[i] = pos->x[i];
+	}
+	for(i=0;i<unl->l;i++)
+	{
+		prob.y[pos->l+i] = -1;
+		prob.x[pos->l+i] = unl->x[i];
+	}
+
+	if(param.gamma == 0 && max_index > 0)
+		param.gamma = 1.0/max_index;
+}
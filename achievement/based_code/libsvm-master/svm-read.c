@@ -0,0 +1,451 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include "svm-read.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define Malloc(type,n) (type *)malloc((n)*sizeof(type))
+
+// A chunk is split off only if each thread gets at least this many bytes.
+#define MIN_CHUNK_SIZE (1<<16)
+
+//
+// The input file is mapped into memory (or read into one buffer when
+// it cannot be mapped, e.g. a pipe or on Windows). Each block is cut
+// into line-aligned chunks. A first parallel scan counts lines and ':'
+// in every chunk, which gives each chunk its first instance and its
+// first node in x_space; a second parallel scan parses the chunks in
+// place. Malformed lines are reported by their line number in the file.
+//
+struct svm_reader
+{
+	char *base;
+	size_t size;
+	size_t pos;		// start of the next block
+	int line_num;		// lines before pos
+	int mapped;
+};
+
+struct chunk
+{
+	const char *begin, *end;
+	int l;			// number of lines
+	size_t elements;	// upper bound of nodes, exact for valid input
+	int error_line;		// first malformed line in the chunk, 0 if none
+	int max_index;
+};
+
+static const double pow10_table[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static int is_blank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static int is_space(char c)
+{
+	return c == '\n' || is_blank(c);
+}
+
+static int is_digit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+// Parse the number occupying exactly [p,end). A decimal with at most
+// 19 digits whose mantissa and power of ten are both exact in double
+// takes one correctly rounded multiplication or division, so the
+// result is the same as strtod. Everything else goes to strtod.
+static int parse_double(const char *p, const char *end, double *value)
+{
+	const char *s = p;
+	int neg = 0, nr_digit = 0, exp10 = 0;
+	unsigned long long m = 0;
+	char buf[64], *str, *endptr;
+	size_t len;
+	int ret;
+
+	if(s < end && (*s == '+' || *s == '-'))
+		neg = (*s++ == '-');
+	for(; s < end && is_digit(*s); s++, nr_digit++)
+		m = m*10 + (unsigned long long)(*s-'0');
+	if(s < end && *s == '.')
+		for(s++; s < end && is_digit(*s); s++, nr_digit++, exp10--)
+			m = m*10 + (unsigned long long)(*s-'0');
+	if(nr_digit == 0 || nr_digit > 19)
+		goto slow;
+	if(s < end && (*s == 'e' || *s == 'E'))
+	{
+		int eneg = 0, e = 0, nr_edigit = 0;
+		s++;
+		if(s < end && (*s == '+' || *s == '-'))
+			eneg = (*s++ == '-');
+		for(; s < end && is_digit(*s); s++, nr_edigit++)
+			if(e < 10000)
+				e = e*10 + (*s-'0');
+		if(nr_edigit == 0)
+			goto slow;
+		exp10 += eneg? -e : e;
+	}
+	if(s != end || m > (1ULL<<53) || exp10 < -22 || exp10 > 22)
+		goto slow;
+	*value = (exp10 < 0)? (double)m/pow10_table[-exp10] : (double)m*pow10_table[exp10];
+	if(neg)
+		*value = -*value;
+	return 0;
+
+slow:
+	len = (size_t)(end-p);
+	str = (len < sizeof(buf))? buf : Malloc(char,len+1);
+	memcpy(str,p,len);
+	str[len] = '\0';
+	errno = 0;
+	*value = strtod(str,&endptr);
+	ret = (len == 0 || endptr != str+len || errno != 0)? -1 : 0;
+	if(str != buf)
+		free(str);
+	return ret;
+}
+
+static int parse_index(const char *p, const char *end, int *index)
+{
+	int neg = 0;
+	long v = 0;
+
+	if(p < end && (*p == '+' || *p == '-'))
+		neg = (*p++ == '-');
+	if(p == end)
+		return -1;
+	for(; p < end; p++)
+	{
+		if(!is_digit(*p))
+			return -1;
+		v = v*10 + (*p-'0');
+		if(v > INT_MAX)
+			return -1;
+	}
+	*index = (int)(neg? -v : v);
+	return 0;
+}
+
+// Parse the line at p into *y and the nodes at *x (terminated by index
+// -1). Returns the start of the next line, or NULL if the line is
+// malformed.
+static const char *parse_line(const char *p, const char *end, double *y, struct svm_node **x, int *max_index)
+{
+	struct svm_node *node = *x;
+	const char *q;
+	int inst_max_index = -1; // precomputed kernel has <index> start from 0
+
+	while(p < end && is_blank(*p))
+		p++;
+	for(q = p; q < end && !is_space(*q); q++);
+	if(q == p || parse_double(p,q,y) != 0) // empty line or bad label
+		return NULL;
+	p = q;
+
+	while(1)
+	{
+		while(p < end && is_blank(*p))
+			p++;
+		if(p == end || *p == '\n')
+			break;
+
+		for(q = p; q < end && *q != ':' && !is_space(*q); q++);
+		if(q == end || *q != ':' || parse_index(p,q,&node->index) != 0 || node->index <= inst_max_index)
+			return NULL;
+		inst_max_index = node->index;
+
+		for(p = q+1; p < end && is_blank(*p); p++);
+		for(q = p; q < end && !is_space(*q); q++);
+		if(parse_double(p,q,&node->value) != 0)
+			return NULL;
+		p = q;
+		node++;
+	}
+	(node++)->index = -1;
+	*x = node;
+	if(inst_max_index > *max_index)
+		*max_index = inst_max_index;
+	return (p < end)? p+1 : p;
+}
+
+static void count_chunk(struct chunk *c)
+{
+	const char *p;
+	size_t nr_line = 0, nr_colon = 0;
+	for(p = c->begin; p < c->end; p++)
+	{
+		nr_line += (*p == '\n');
+		nr_colon += (*p == ':');
+	}
+	if(c->end > c->begin && c->end[-1] != '\n') // last line without '\n'
+		nr_line++;
+	c->l = (int)nr_line;
+	c->elements = nr_colon + nr_line;
+}
+
+static void parse_chunk(struct chunk *c, int line_num, double *y, struct svm_node **x, struct svm_node *x_space)
+{
+	const char *p = c->begin;
+	int i;
+	c->error_line = 0;
+	c->max_index = 0;
+	for(i=0;i<c->l;i++)
+	{
+		x[i] = x_space;
+		p = parse_line(p,c->end,&y[i],&x_space,&c->max_index);
+		if(p == NULL)
+		{
+			c->error_line = line_num+i+1;
+			return;
+		}
+	}
+}
+
+struct svm_reader *svm_open_reader(const char *filename)
+{
+	struct svm_reader *reader;
+	FILE *fp;
+	size_t n, capacity;
+#ifndef _WIN32
+	struct stat st;
+	int fd = open(filename,O_RDONLY);
+	if(fd < 0)
+		return NULL;
+	if(fstat(fd,&st) == 0 && S_ISREG(st.st_mode))
+	{
+		void *base = NULL;
+		if(st.st_size > 0)
+		{
+			base = mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+			if(base != MAP_FAILED)
+				madvise(base,(size_t)st.st_size,MADV_SEQUENTIAL);
+		}
+		if(base != MAP_FAILED)
+		{
+			close(fd);
+			reader = Malloc(struct svm_reader,1);
+			reader->base = (char *)base;
+			reader->size = (size_t)st.st_size;
+			reader->pos = 0;
+			reader->line_num = 0;
+			reader->mapped = (base != NULL);
+			return reader;
+		}
+	}
+	close(fd);
+#endif
+	fp = fopen(filename,"rb");
+	if(fp == NULL)
+		return NULL;
+	reader = Malloc(struct svm_reader,1);
+	capacity = 1<<20;
+	reader->base = Malloc(char,capacity);
+	reader->size = 0;
+	while((n = fread(reader->base+reader->size,1,capacity-reader->size,fp)) > 0)
+	{
+		reader->size += n;
+		if(reader->size == capacity)
+		{
+			capacity *= 2;
+			reader->base = (char *)realloc(reader->base,capacity);
+		}
+	}
+	fclose(fp);
+	reader->pos = 0;
+	reader->line_num = 0;
+	reader->mapped = 0;
+	return reader;
+}
+
+void svm_close_reader(struct svm_reader *reader)
+{
+	if(reader == NULL)
+		return;
+#ifndef _WIN32
+	if(reader->mapped)
+		munmap(reader->base,reader->size);
+	else
+#endif
+		free(reader->base);
+	free(reader);
+}
+
+void svm_rewind_reader(struct svm_reader *reader)
+{
+	reader->pos = 0;
+	reader->line_num = 0;
+}
+
+//
+// Read the lines in the next block_size bytes (extended to the end of
+// the last line; 0 for the rest of the file) into data, reusing its
+// arrays. data must be zero-initialized before the first call. Returns
+// 0 with data->prob.l = 0 at the end of the file, or the line number
+// of the first malformed line.
+//
+int svm_read_next(struct svm_reader *reader, size_t block_size, int nr_thread, struct svm_data *data)
+{
+	const char *begin = reader->base+reader->pos;
+	const char *end = reader->base+reader->size;
+	struct chunk *chunks;
+	int nr_chunk, i, l = 0, error_line = 0;
+	size_t elements = 0;
+
+	if(block_size > 0 && block_size < (size_t)(end-begin))
+	{
+		const char *p = (const char *)memchr(begin+block_size,'\n',(size_t)(end-begin)-block_size);
+		if(p != NULL)
+			end = p+1;
+	}
+
+#ifdef _OPENMP
+	if(nr_thread <= 0)
+		nr_thread = omp_get_max_threads();
+#else
+	nr_thread = 1;
+#endif
+	nr_chunk = 4*nr_thread;
+	if((size_t)nr_chunk > (size_t)(end-begin)/MIN_CHUNK_SIZE)
+		nr_chunk = (int)((size_t)(end-begin)/MIN_CHUNK_SIZE);
+	if(nr_chunk < 1)
+		nr_chunk = 1;
+
+	chunks = Malloc(struct chunk,nr_chunk);
+	for(i=0;i<nr_chunk;i++)
+	{
+		const char *p = begin + (size_t)(end-begin)/(size_t)nr_chunk*(size_t)i;
+		if(i > 0)
+		{
+			if(p < chunks[i-1].begin)
+				p = chunks[i-1].begin;
+			p = (const char *)memchr(p,'\n',(size_t)(end-p));
+			p = (p == NULL)? end : p+1;
+			chunks[i-1].end = p;
+		}
+		chunks[i].begin = p;
+	}
+	chunks[nr_chunk-1].end = end;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nr_thread) if(nr_chunk > 1)
+#endif
+	for(i=0;i<nr_chunk;i++)
+		count_chunk(&chunks[i]);
+
+	for(i=0;i<nr_chunk;i++)
+	{
+		l += chunks[i].l;
+		elements += chunks[i].elements;
+	}
+	if(l > data->max_l)
+	{
+		data->max_l = l;
+		data->prob.y = (double *)realloc(data->prob.y,(size_t)l*sizeof(double));
+		data->prob.x = (struct svm_node **)realloc(data->prob.x,(size_t)l*sizeof(struct svm_node *));
+	}
+	if(elements > data->max_elements)
+	{
+		data->max_elements = elements;
+		data->x_space = (struct svm_node *)realloc(data->x_space,elements*sizeof(struct svm_node));
+	}
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nr_thread) if(nr_chunk > 1)
+#endif
+	for(i=0;i<nr_chunk;i++)
+	{
+		int j, line_start = 0;
+		size_t element_start = 0;
+		for(j=0;j<i;j++)
+		{
+			line_start += chunks[j].l;
+			element_start += chunks[j].elements;
+		}
+		parse_chunk(&chunks[i],reader->line_num+line_start,data->prob.y+line_start,
+			data->prob.x+line_start,data->x_space+element_start);
+	}
+
+	data->prob.l = l;
+	data->max_index = 0;
+	for(i=0;i<nr_chunk;i++)
+	{
+		if(chunks[i].error_line != 0 && error_line == 0)
+			error_line = chunks[i].error_line;
+		if(chunks[i].max_index > data->max_index)
+			data->max_index = chunks[i].max_index;
+	}
+	free(chunks);
+
+	reader->pos = (size_t)(end-reader->base);
+	reader->line_num += l;
+	return error_line;
+}
+
+void svm_free_data(struct svm_data *data)
+{
+	free(data->prob.y);
+	free(data->prob.x);
+	free(data->x_space);
+	data->prob.y = NULL;
+	data->prob.x = NULL;
+	data->x_space = NULL;
+	data->prob.l = data->max_l = 0;
+	data->max_elements = 0;
+}
+
+int svm_read_problem(const char *filename, int nr_thread, struct svm_data *data, struct svm_problem **binary_prob)
+{
+	struct svm_reader *reader;
+	int i, error_line;
+
+	memset(data,0,sizeof(*data));
+	*binary_prob = svm_load_problem(filename);
+	if(*binary_prob != NULL)
+	{
+		// used in place; only the largest index is needed
+		data->prob = **binary_prob;
+		for(i=0;i<data->prob.l;i++)
+		{
+			const struct svm_node *x = data->prob.x[i];
+			for(;x->index != -1;x++)
+				if(x->index > data->max_index)
+					data->max_index = x->index;
+		}
+		return 0;
+	}
+
+	reader = svm_open_reader(filename);
+	if(reader == NULL)
+		return -1;
+	error_line = svm_read_next(reader,0,nr_thread,data);
+	svm_close_reader(reader);
+	return error_line;
+}
+
+const char *svm_check_precomputed(const struct svm_problem *prob, int max_index)
+{
+	int i;
+	for(i=0;i<prob->l;i++)
+	{
+		if(prob->x[i][0].index != 0)
+			return "first column must be 0:sample_serial_number";
+		if((int)prob->x[i][0].value <= 0 || (int)prob->x[i][0].value > max_index)
+			return "sample_serial_number out of range";
+	}
+	return NULL;
+}
@@ -0,0 +1,44 @@
+#ifndef _SVM_READ_H
+#define _SVM_READ_H
+
+#include <stddef.h>
+#include "svm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// default number of bytes parsed at a time by svm-predict and svm-scale
+#define SVM_READ_BLOCK_SIZE (64<<20)
+
+struct svm_reader;
+
+struct svm_data
+{
+	struct svm_problem prob;	// prob.x[i] points into x_space
+	struct svm_node *x_space;
+	int max_index;			// largest feature index read, 0 if none
+	int max_l;			// allocated lengths of prob.y/prob.x and x_space
+	size_t max_elements;
+};
+
+struct svm_reader *svm_open_reader(const char *filename);
+void svm_close_reader(struct svm_reader *reader);
+void svm_rewind_reader(struct svm_reader *reader);
+int svm_read_next(struct svm_reader *reader, size_t block_size, int nr_thread, struct svm_data *data);
+void svm_free_data(struct svm_data *data);
+
+// Read a whole data file, in svmlight format or the binary format of
+// svm-convert. A binary file is used in place: *binary_prob is set,
+// data->prob is a shallow copy of it and data->x_space is NULL; free it
+// with svm_free_and_destroy_problem instead of svm_free_data. Returns 0,
+// -1 if the file cannot be opened, or the first malformed line.
+int svm_read_problem(const char *filename, int nr_thread, struct svm_data *data, struct svm_problem **binary_prob);
+// NULL if every instance starts with a valid 0:sample_serial_number
+const char *svm_check_precomputed(const struct svm_problem *prob, int max_index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SVM_READ_H */
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <string.h>
+#include "svm-read.h"
 
 void exit_with_help()
 {
@@ -37,12 +38,26 @@ long int new_num_nonzeros = 0;
 void output_target(double value);
 void output(int index, double value);
 char* readline(FILE *input);
-int clean_up(FILE *fp_restore, FILE *fp, const char *msg);
+int clean_up(FILE *fp_restore, struct svm_reader *reader, const char *msg);
+
+// the data file is parsed a block at a time in each pass
+struct svm_data data;
+
+void read_block(struct svm_reader *reader)
+{
+	int error_line = svm_read_next(reader,SVM_READ_BLOCK_SIZE,0,&data);
+	if(error_line != 0)
+	{
+		fprintf(stderr,"Wrong input format at line %d\n", error_line);
+		exit(1);
+	}
+}
 
 int main(int argc,char **argv)
 {
-	int i,index;
-	FILE *fp, *fp_restore = NULL;
+	int i,j,index;
+	struct svm_reader *reader;
+	FILE *fp_restore = NULL;
 	char *save_filename = NULL;
 	char *restore_filename = NULL;
 
@@ -83,9 +98,9 @@ int main(int argc,char **argv)
 	if(argc != i+1) 
 		exit_with_help();
 
-	fp=fopen(argv[i],"r");
+	reader=svm_open_reader(argv[i]);
 	
-	if(fp==NULL)
+	if(reader==NULL)
 	{
 		fprintf(stderr,"can't open file %s\n", argv[i]);
 		exit(1);
@@ -93,16 +108,6 @@ int main(int argc,char **argv)
 
 	line = (char *) malloc(max_line_len*sizeof(char));
 
-#define SKIP_TARGET\
-	while(isspace(*p)) ++p;\
-	while(!isspace(*p)) ++p;
-
-#define SKIP_ELEMENT\
-	while(*p!=':') ++p;\
-	++p;\
-	while(isspace(*p)) ++p;\
-	while(*p && !isspace(*p)) ++p;
-	
 	/* assumption: min index of attributes is 1 */
 	/* pass 1: find out max index of attributes */
 	max_index = 0;
@@ -134,26 +139,24 @@ int main(int argc,char **argv)
 		rewind(fp_restore);
 	}
 
-	while(readline(fp)!=NULL)
-	{
-		char *p=line;
-
-		SKIP_TARGET
-
-		while(sscanf(p,"%d:%*f",&index)==1)
+	for(read_block(reader);data.prob.l>0;read_block(reader))
+		for(j=0;j<data.prob.l;j++)
 		{
-			max_index = max(max_index, index);
-			min_index = min(min_index, index);
-			SKIP_ELEMENT
-			num_nonzeros++;
+			const struct svm_node *x=data.prob.x[j];
+
+			for(;x->index!=-1;x++)
+			{
+				max_index = max(max_index, x->index);
+				min_index = min(min_index, x->index);
+				num_nonzeros++;
+			}
 		}
-	}
 
 	if(min_index < 1)
 		fprintf(stderr,
 			"WARNING: minimal feature index is %d, but indices should start from 1\n", min_index);
 
-	rewind(fp);
+	svm_rewind_reader(reader);
 
 	feature_max = (double *)malloc((max_index+1)* sizeof(double));
 	feature_min = (double *)malloc((max_index+1)* sizeof(double));
@@ -171,43 +174,39 @@ int main(int argc,char **argv)
 	}
 
 	/* pass 2: find out min/max value */
-	while(readline(fp)!=NULL)
-	{
-		char *p=line;
-		int next_index=1;
-		double target;
-		double value;
-
-		if (sscanf(p,"%lf",&target) != 1)
-			return clean_up(fp_restore, fp, "ERROR: failed to read labels\n");
-		y_max = max(y_max,target);
-		y_min = min(y_min,target);
-		
-		SKIP_TARGET
-
-		while(sscanf(p,"%d:%lf",&index,&value)==2)
+	for(read_block(reader);data.prob.l>0;read_block(reader))
+		for(j=0;j<data.prob.l;j++)
 		{
-			for(i=next_index;i<index;i++)
+			const struct svm_node *x=data.prob.x[j];
+			int next_index=1;
+			double target=data.prob.y[j];
+
+			y_max = max(y_max,target);
+			y_min = min(y_min,target);
+
+			for(;x->index!=-1;x++)
+			{
+				index=x->index;
+				for(i=next_index;i<index;i++)
+				{
+					feature_max[i]=max(feature_max[i],0);
+					feature_min[i]=min(feature_min[i],0);
+				}
+
+				feature_max[index]=max(feature_max[index],x->value);
+				feature_min[index]=min(feature_min[index],x->value);
+
+				next_index=index+1;
+			}
+
+			for(i=next_index;i<=max_index;i++)
 			{
 				feature_max[i]=max(feature_max[i],0);
 				feature_min[i]=min(feature_min[i],0);
 			}
-			
-			feature_max[index]=max(feature_max[index],value);
-			feature_min[index]=min(feature_min[index],value);
-
-			SKIP_ELEMENT
-			next_index=index+1;
-		}		
-
-		for(i=next_index;i<=max_index;i++)
-		{
-			feature_max[i]=max(feature_max[i],0);
-			feature_min[i]=min(feature_min[i],0);
-		}	
-	}
+		}
 
-	rewind(fp);
+	svm_rewind_reader(reader);
 
 	/* pass 2.5: save/restore feature_min/feature_max */
 	
@@ -222,7 +221,7 @@ int main(int argc,char **argv)
 		{
 			if(fscanf(fp_restore, "%lf %lf\n", &y_lower, &y_upper) != 2 ||
 			   fscanf(fp_restore, "%lf %lf\n", &y_min, &y_max) != 2)
-				return clean_up(fp_restore, fp, "ERROR: failed to read scaling parameters\n");
+				return clean_up(fp_restore, reader, "ERROR: failed to read scaling parameters\n");
 			y_scaling = 1;
 		}
 		else
@@ -231,7 +230,7 @@ int main(int argc,char **argv)
 		if (fgetc(fp_restore) == 'x') 
 		{
 			if(fscanf(fp_restore, "%lf %lf\n", &lower, &upper) != 2)
-				return clean_up(fp_restore, fp, "ERROR: failed to read scaling parameters\n");
+				return clean_up(fp_restore, reader, "ERROR: failed to read scaling parameters\n");
 			while(fscanf(fp_restore,"%d %lf %lf\n",&idx,&fmin,&fmax)==3)
 			{
 				for(i = next_index;i<idx;i++)
@@ -285,35 +284,29 @@ int main(int argc,char **argv)
 	}
 	
 	/* pass 3: scale */
-	while(readline(fp)!=NULL)
-	{
-		char *p=line;
-		int next_index=1;
-		double target;
-		double value;
-		
-		if (sscanf(p,"%lf",&target) != 1)
-			return clean_up(NULL, fp, "ERROR: failed to read labels\n");
-		output_target(target);
+	for(read_block(reader);data.prob.l>0;read_block(reader))
+		for(j=0;j<data.prob.l;j++)
+		{
+			const struct svm_node *x=data.prob.x[j];
+			int next_index=1;
 
-		SKIP_TARGET
+			output_target(data.prob.y[j]);
 
-		while(sscanf(p,"%d:%lf",&index,&value)==2)
-		{
-			for(i=next_index;i<index;i++)
-				output(i,0);
-			
-			output(index,value);
+			for(;x->index!=-1;x++)
+			{
+				for(i=next_index;i<x->index;i++)
+					output(i,0);
 
-			SKIP_ELEMENT
-			next_index=index+1;
-		}		
+				output(x->index,x->value);
 
-		for(i=next_index;i<=max_index;i++)
-			output(i,0);
+				next_index=x->index+1;
+			}
 
-		printf("\n");
-	}
+			for(i=next_index;i<=max_index;i++)
+				output(i,0);
+
+			printf("\n");
+		}
 
 	if (new_num_nonzeros > num_nonzeros)
 		fprintf(stderr, 
@@ -325,7 +318,8 @@ int main(int argc,char **argv)
 	free(line);
 	free(feature_max);
 	free(feature_min);
-	fclose(fp);
+	svm_free_data(&data);
+	svm_close_reader(reader);
 	return 0;
 }
 
@@ -383,13 +377,14 @@ void output(int index, double value)
 	}
 }
 
-int clean_up(FILE *fp_restore, FILE *fp, const char* msg)
+int clean_up(FILE *fp_restore, struct svm_reader *reader, const char* msg)
 {
 	fprintf(stderr,	"%s", msg);
 	free(line);
 	free(feature_max);
 	free(feature_min);
-	fclose(fp);
+	svm_free_data(&data);
+	svm_close_reader(reader);
 	if (fp_restore)
 		fclose(fp_restore);
 	return -1;
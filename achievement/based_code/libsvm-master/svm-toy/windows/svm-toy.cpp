@@ -192,6 +192,9 @@ void button_run_clicked()
 	param.p = 0.1;
 	param.shrinking = 1;
 	param.probability = 0;
+	param.nr_thread = 0;
+	param.single_precision = 0;
+	param.active_cache_size = 0;
 	param.nr_weight = 0;
 	param.weight_label = NULL;
 	param.weight = NULL;
@@ -4,6 +4,7 @@
 #include <ctype.h>
 #include <errno.h>
 #include "svm.h"
+#include "svm-read.h"
 #define Malloc(type,n) (type *)malloc((n)*sizeof(type))
 
 void print_null(const char *s) {}
@@ -37,6 +38,9 @@ void exit_with_help()
 	"-b probability_estimates : whether to train a SVC or SVR model for probability estimates, 0 or 1 (default 0)\n"
 	"-wi weight : set the parameter C of class i to weight*C, for C-SVC (default 1)\n"
 	"-v n: n-fold cross validation mode\n"
+	"-j nr_thread : set the number of threads for kernel evaluation and cross validation folds (default 0, the OpenMP default)\n"
+	"-f single_precision : whether to evaluate kernels in single precision with SIMD, 0 or 1 (default 0)\n"
+	"-o active_cache_size : prefetch the active instances of at most this size in MB for out-of-core training (default 0)\n"
 	"-q : quiet mode (no outputs)\n"
 	);
 	exit(1);
@@ -50,36 +54,16 @@ void exit_input_error(int line_num)
 
 void parse_command_line(int argc, char **argv, char *input_file_name, char *model_file_name);
 void read_problem(const char *filename);
-void do_cross_validation();
+void do_cross_validation(const char *model_file_name);
 
 struct svm_parameter param;		// set by parse_command_line
 struct svm_problem prob;		// set by read_problem
 struct svm_model *model;
-struct svm_node *x_space;
+struct svm_data data;			// set by read_problem
+struct svm_problem *binary_prob;	// set by read_problem for a binary data file
 int cross_validation;
 int nr_fold;
 
-static char *line = NULL;
-static int max_line_len;
-
-static char* readline(FILE *input)
-{
-	int len;
-	
-	if(fgets(line,max_line_len,input) == NULL)
-		return NULL;
-
-	while(strrchr(line,'\n') == NULL)
-	{
-		max_line_len *= 2;
-		line = (char *) realloc(line,max_line_len);
-		len = (int) strlen(line);
-		if(fgets(line+len,max_line_len-len,input) == NULL)
-			break;
-	}
-	return line;
-}
-
 int main(int argc, char **argv)
 {
 	char input_file_name[1024];
@@ -98,7 +82,7 @@ int main(int argc, char **argv)
 
 	if(cross_validation)
 	{
-		do_cross_validation();
+		do_cross_validation(model_file_name);
 	}
 	else
 	{
@@ -111,15 +95,15 @@ int main(int argc, char **argv)
 		svm_free_and_destroy_model(&model);
 	}
 	svm_destroy_param(&param);
-	free(prob.y);
-	free(prob.x);
-	free(x_space);
-	free(line);
+	if(binary_prob)
+		svm_free_and_destroy_problem(&binary_prob);
+	else
+		svm_free_data(&data);
 
 	return 0;
 }
 
-void do_cross_validation()
+void do_cross_validation(const char *model_file_name)
 {
 	int i;
 	int total_correct = 0;
@@ -127,7 +111,20 @@ void do_cross_validation()
 	double sumv = 0, sumy = 0, sumvv = 0, sumyy = 0, sumvy = 0;
 	double *target = Malloc(double,prob.l);
 
-	svm_cross_validation(&prob,&param,nr_fold,target);
+	if(param.probability)
+	{
+		// the model is calibrated on the cross validation instead of
+		// on 5 more trainings, so it is saved as well
+		model = svm_train_cross_validation(&prob,&param,nr_fold,target);
+		if(svm_save_model(model_file_name,model))
+		{
+			fprintf(stderr, "can't save model to file %s\n", model_file_name);
+			exit(1);
+		}
+		svm_free_and_destroy_model(&model);
+	}
+	else
+		svm_cross_validation(&prob,&param,nr_fold,target);
 	if(param.svm_type == EPSILON_SVR ||
 	   param.svm_type == NU_SVR)
 	{
@@ -179,6 +176,9 @@ void parse_command_line(int argc, char **argv, char *input_file_name, char *mode
 	param.nr_weight = 0;
 	param.weight_label = NULL;
 	param.weight = NULL;
+	param.nr_thread = 0;
+	param.single_precision = 0;
+	param.active_cache_size = 0;
 	cross_validation = 0;
 
 	// parse options
@@ -225,6 +225,15 @@ void parse_command_line(int argc, char **argv, char *input_file_name, char *mode
 			case 'b':
 				param.probability = atoi(argv[i]);
 				break;
+			case 'j':
+				param.nr_thread = atoi(argv[i]);
+				break;
+			case 'f':
+				param.single_precision = atoi(argv[i]);
+				break;
+			case 'o':
+				param.active_cache_size = atof(argv[i]);
+				break;
 			case 'q':
 				print_func = &print_null;
 				i--;
@@ -273,108 +282,28 @@ void parse_command_line(int argc, char **argv, char *input_file_name, char *mode
 	}
 }
 
-// read in a problem (in svmlight format)
+// read in a problem (in svmlight format or the binary format of svm-convert)
 
 void read_problem(const char *filename)
 {
-	int max_index, inst_max_index, i;
-	size_t elements, j;
-	FILE *fp = fopen(filename,"r");
-	char *endptr;
-	char *idx, *val, *label;
+	const char *error_msg;
+	int error_line = svm_read_problem(filename,param.nr_thread,&data,&binary_prob);
 
-	if(fp == NULL)
+	if(error_line < 0)
 	{
 		fprintf(stderr,"can't open input file %s\n",filename);
 		exit(1);
 	}
+	if(error_line > 0)
+		exit_input_error(error_line);
+	prob = data.prob;
 
-	prob.l = 0;
-	elements = 0;
-
-	max_line_len = 1024;
-	line = Malloc(char,max_line_len);
-	while(readline(fp)!=NULL)
-	{
-		char *p = strtok(line," \t"); // label
-
-		// features
-		while(1)
-		{
-			p = strtok(NULL," \t");
-			if(p == NULL || *p == '\n') // check '\n' as ' ' may be after the last feature
-				break;
-			++elements;
-		}
-		++elements;
-		++prob.l;
-	}
-	rewind(fp);
-
-	prob.y = Malloc(double,prob.l);
-	prob.x = Malloc(struct svm_node *,prob.l);
-	x_space = Malloc(struct svm_node,elements);
+	if(param.gamma == 0 && data.max_index > 0)
+		param.gamma = 1.0/data.max_index;
 
-	max_index = 0;
-	j=0;
-	for(i=0;i<prob.l;i++)
+	if(param.kernel_type == PRECOMPUTED && (error_msg = svm_check_precomputed(&prob,data.max_index)) != NULL)
 	{
-		inst_max_index = -1; // strtol gives 0 if wrong format, and precomputed kernel has <index> start from 0
-		readline(fp);
-		prob.x[i] = &x_space[j];
-		label = strtok(line," \t\n");
-		if(label == NULL) // empty line
-			exit_input_error(i+1);
-
-		prob.y[i] = strtod(label,&endptr);
-		if(endptr == label || *endptr != '\0')
-			exit_input_error(i+1);
-
-		while(1)
-		{
-			idx = strtok(NULL,":");
-			val = strtok(NULL," \t");
-
-			if(val == NULL)
-				break;
-
-			errno = 0;
-			x_space[j].index = (int) strtol(idx,&endptr,10);
-			if(endptr == idx || errno != 0 || *endptr != '\0' || x_space[j].index <= inst_max_index)
-				exit_input_error(i+1);
-			else
-				inst_max_index = x_space[j].index;
-
-			errno = 0;
-			x_space[j].value = strtod(val,&endptr);
-			if(endptr == val || errno != 0 || (*endptr != '\0' && !isspace(*endptr)))
-				exit_input_error(i+1);
-
-			++j;
-		}
-
-		if(inst_max_index > max_index)
-			max_index = inst_max_index;
-		x_space[j++].index = -1;
+		fprintf(stderr,"Wrong input format: %s\n",error_msg);
+		exit(1);
 	}
-
-	if(param.gamma == 0 && max_index > 0)
-		param.gamma = 1.0/max_index;
-
-	if(param.kernel_type == PRECOMPUTED)
-		for(i=0;i<prob.l;i++)
-		{
-			if (prob.x[i][0].index != 0)
-			{
-				fprintf(stderr,"Wrong input format: first column must be 0:sample_serial_number\n");
-				exit(1);
-			}
-			if ((int)prob.x[i][0].value <= 0 || (int)prob.x[i][0].value > max_index)
-			{
-				fprintf(stderr,"Wrong input format: sample_serial_number out of range\n");
-				exit(1);
-			}
-		}
-
-	fclose(fp);
 }
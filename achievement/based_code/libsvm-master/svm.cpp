@@ -6,7 +6,17 @@
 #include <string.h>
 #include <stdarg.h>
 #include <limits.h>
+#include <stdint.h>
 #include <locale.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "svm.h"
 int libsvm_version = LIBSVM_VERSION;
 typedef float Qfloat;
@@ -64,6 +74,11 @@ static void info(const char *fmt,...) {}
 // l is the number of total data items
 // size is the cache size limit in bytes
 //
+// Columns live in fixed slots of l Qfloats carved from one arena that
+// is allocated up front. swap_index only records the swap in a journal;
+// a cached column replays the swaps it has missed the next time it is
+// requested, so a swap costs O(1) instead of a walk over all columns.
+//
 class Cache
 {
 public:
@@ -77,33 +92,53 @@ public:
 	void swap_index(int i, int j);
 private:
 	int l;
-	long int size;
+	int nr_slot;		// number of columns the arena holds
+	Qfloat *arena;
+	Qfloat **free_slot;	// free_slot[0,nr_free) are unused slots
+	int nr_free;
 	struct head_t
 	{
 		head_t *prev, *next;	// a circular list
 		Qfloat *data;
 		int len;		// data[0,len) is cached in this entry
+		int applied;		// journal[0,applied) has been applied to data
 	};
 
 	head_t *head;
 	head_t lru_head;
+	int *journal;		// swapped pairs (journal[2k],journal[2k+1]), first < second
+	int journal_len;
+	int journal_max;
+	long int nr_hit, nr_miss, nr_evict;
 	void lru_delete(head_t *h);
 	void lru_insert(head_t *h);
+	void replay(head_t *h);
+	void release(head_t *h);
 };
 
-Cache::Cache(int l_,long int size_):l(l_),size(size_)
+Cache::Cache(int l_,long int size_):l(l_)
 {
 	head = (head_t *)calloc(l,sizeof(head_t));	// initialized to 0
-	size /= sizeof(Qfloat);
-	size -= l * sizeof(head_t) / sizeof(Qfloat);
-	size = max(size, 2 * (long int) l);	// cache must be large enough for two columns
+	journal_max = max(l,1);
+	journal = Malloc(int,2*journal_max);
+	journal_len = 0;
+	long int size = size_/sizeof(Qfloat);
+	size -= (l * sizeof(head_t) + 2 * journal_max * sizeof(int)) / sizeof(Qfloat);
+	nr_slot = (int)max(min(size / max(l,1), (long int) l), 2L);	// cache must be large enough for two columns
+	arena = Malloc(Qfloat,(size_t)nr_slot*l);
+	free_slot = Malloc(Qfloat *,nr_slot);
+	for(nr_free=0;nr_free<nr_slot;nr_free++)
+		free_slot[nr_free] = &arena[(size_t)(nr_slot-1-nr_free)*l];
 	lru_head.next = lru_head.prev = &lru_head;
+	nr_hit = nr_miss = nr_evict = 0;
 }
 
 Cache::~Cache()
 {
-	for(head_t *h = lru_head.next; h != &lru_head; h=h->next)
-		free(h->data);
+	info("cache hits = %ld, misses = %ld, evictions = %ld\n",nr_hit,nr_miss,nr_evict);
+	free(arena);
+	free(free_slot);
+	free(journal);
 	free(head);
 }
 
@@ -123,32 +158,61 @@ void Cache::lru_insert(head_t *h)
 	h->next->prev = h;
 }
 
+void Cache::replay(head_t *h)
+{
+	for(int k=h->applied;k<journal_len && h->len > 0;k++)
+	{
+		int i = journal[2*k];
+		int j = journal[2*k+1];
+		if(h->len > j)
+			swap(h->data[i],h->data[j]);
+		else if(h->len > i)
+			h->len = i;	// data[i] moved out of the cached range
+	}
+	h->applied = journal_len;
+}
+
+// give the slot of h, which is not in the list, back to the arena
+void Cache::release(head_t *h)
+{
+	free_slot[nr_free++] = h->data;
+	h->data = 0;
+	h->len = 0;
+}
+
 int Cache::get_data(const int index, Qfloat **data, int len)
 {
 	head_t *h = &head[index];
-	if(h->len) lru_delete(h);
+	if(h->len)
+	{
+		lru_delete(h);
+		replay(h);
+		if(h->len == 0)
+			release(h);
+	}
 	int more = len - h->len;
 
 	if(more > 0)
 	{
-		// free old space
-		while(size < more)
+		++nr_miss;
+		if(h->data == 0)
 		{
-			head_t *old = lru_head.next;
-			lru_delete(old);
-			free(old->data);
-			size += old->len;
-			old->data = 0;
-			old->len = 0;
+			if(nr_free == 0)
+			{
+				head_t *old = lru_head.next;
+				lru_delete(old);
+				release(old);
+				++nr_evict;
+			}
+			h->data = free_slot[--nr_free];
 		}
-
-		// allocate new space
-		h->data = (Qfloat *)realloc(h->data,sizeof(Qfloat)*len);
-		size -= more;
 		swap(h->len,len);
 	}
+	else
+		++nr_hit;
 
-	lru_insert(h);
+	h->applied = journal_len;
+	if(h->len) lru_insert(h);
 	*data = h->data;
 	return len;
 }
@@ -161,27 +225,31 @@ void Cache::swap_index(int i, int j)
 	if(head[j].len) lru_delete(&head[j]);
 	swap(head[i].data,head[j].data);
 	swap(head[i].len,head[j].len);
+	swap(head[i].applied,head[j].applied);
 	if(head[i].len) lru_insert(&head[i]);
 	if(head[j].len) lru_insert(&head[j]);
 
-	if(i>j) swap(i,j);
-	for(head_t *h = lru_head.next; h!=&lru_head; h=h->next)
+	if(journal_len == journal_max)
 	{
-		if(h->len > i)
+		// bring every column up to date and start a new journal
+		for(head_t *h = lru_head.next, *next; h!=&lru_head; h=next)
 		{
-			if(h->len > j)
-				swap(h->data[i],h->data[j]);
-			else
+			next = h->next;
+			replay(h);
+			h->applied = 0;
+			if(h->len == 0)
 			{
-				// give up
 				lru_delete(h);
-				free(h->data);
-				size += h->len;
-				h->data = 0;
-				h->len = 0;
+				release(h);
 			}
 		}
+		journal_len = 0;
 	}
+
+	if(i>j) swap(i,j);
+	journal[2*journal_len] = i;
+	journal[2*journal_len+1] = j;
+	++journal_len;
 }
 
 //
@@ -191,17 +259,112 @@ void Cache::swap_index(int i, int j)
 // the constructor of Kernel prepares to calculate the l*l kernel matrix
 // the member function get_Q is for getting one column from the Q Matrix
 //
+// kernel_column fills a column with one thread per chunk of rows; every
+// entry is computed independently, so the result does not depend on the
+// number of threads. Short columns are filled serially.
+//
+// For the column loop the constructor picks one of two layouts of x:
+// a dense row-major copy when the data is dense enough that the copy is
+// not larger than the svm_node arrays, otherwise a scatter vector into
+// which x[i] is expanded once per column so that every K(i,j) becomes a
+// branch-free gather over x[j]. Both add the same products in the same
+// order as dot(), so the kernel values are unchanged.
+//
+#define PARALLEL_COLUMN_MIN 1024
+
+//
+// Single precision kernel columns (svm_parameter.single_precision)
+//
+// The layouts are stored as float and a column is filled in blocks of
+// COLUMN_BLOCK entries: first the dot products, then the kernel over
+// the whole block. exp_float is a branch-free expf (Cephes polynomial,
+// relative error below 2e-7) so that the RBF loop vectorizes. Where
+// GCC supports target_clones, the block loops are compiled for
+// AVX-512, AVX2 and the baseline ISA and one is picked at run time.
+//
+#define COLUMN_BLOCK 1024
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define SIMD_CLONES __attribute__((target_clones("avx512f","avx2","default")))
+// for double precision loops that must round as the scalar code does
+#define SIMD_CLONES_EXACT __attribute__((target_clones("avx512f","avx2","default"),optimize("fp-contract=off")))
+#else
+#define SIMD_CLONES
+#define SIMD_CLONES_EXACT
+#endif
+#if defined(_OPENMP) && _OPENMP >= 201307
+#define PRAGMA_SIMD_SUM _Pragma("omp simd reduction(+:sum)")
+#else
+#define PRAGMA_SIMD_SUM
+#endif
+
+static inline float exp_float(float x)
+{
+	float t = (x < 88.3f)? x : 88.3f;
+	t = (t > -87.3f)? t : -87.3f;
+	float n = floorf(t*1.44269504088896341f+0.5f);
+	float r = t - n*0.693359375f + n*2.12194440e-4f;
+	float p = 1.9875691500e-4f;
+	p = p*r + 1.3981999507e-3f;
+	p = p*r + 8.3334519073e-3f;
+	p = p*r + 4.1665795894e-2f;
+	p = p*r + 1.6666665459e-1f;
+	p = p*r + 5.0000001201e-1f;
+	p = p*r*r + r + 1.0f;
+	union { int i; float f; } scale;
+	scale.i = ((int)n+127) << 23;
+	return (x < -87.3f)? 0.0f : p*scale.f;
+}
+
+SIMD_CLONES
+static void dense_dot_column_float(const float *xi, float * const *x, int dim, float *data, int n)
+{
+	for(int j=0;j<n;j++)
+	{
+		const float *xj = x[j];
+		float sum = 0;
+		PRAGMA_SIMD_SUM
+		for(int k=0;k<dim;k++)
+			sum += xi[k]*xj[k];
+		data[j] = sum;
+	}
+}
+
+// data[j] = exp(-gamma*|x_i-x_j|^2) from data[j] = x_i'x_j
+SIMD_CLONES
+static void rbf_column_float(float *data, const float *x_square, float xi_square, float gamma, int n)
+{
+	for(int j=0;j<n;j++)
+	{
+		float t = -gamma*(xi_square+x_square[j]-2*data[j]);
+		data[j] = exp_float((t < 0)? t : 0);	// rounding may make |x_i-x_j|^2 negative
+	}
+}
+
+SIMD_CLONES
+static void sign_column_float(float *data, const schar *y, int yi, int n)
+{
+	for(int j=0;j<n;j++)
+		data[j] *= (float)(yi*y[j]);
+}
+
+// data[j] = K(index[i],index[j]) for j in [start,len) from the rows of a
+// svm_kernel_cache, scaled by y[i]*y[j] if y != NULL
+static void shared_kernel_column(svm_kernel_cache *shared, const int *index,
+	int i, int start, int len, Qfloat *data, const schar *y);
+
 class QMatrix {
 public:
 	virtual Qfloat *get_Q(int column, int len) const = 0;
 	virtual double *get_QD() const = 0;
 	virtual void swap_index(int i, int j) const = 0;
+	// called by the solver after shrinking to variables [0,active_size)
+	virtual void set_active_size(int active_size) const {}
 	virtual ~QMatrix() {}
 };
 
 class Kernel: public QMatrix {
 public:
-	Kernel(int l, svm_node * const * x, const svm_parameter& param);
+	Kernel(int l, svm_node * const * x, const svm_parameter& param, svm_kernel_cache *shared = NULL);
 	virtual ~Kernel();
 
 	static double k_function(const svm_node *x, const svm_node *y,
@@ -212,14 +375,56 @@ public:
 	{
 		swap(x[i],x[j]);
 		if(x_square) swap(x_square[i],x_square[j]);
+		if(x_dense) swap(x_dense[i],x_dense[j]);
+		if(xf_dense) swap(xf_dense[i],xf_dense[j]);
+		if(xf_square) swap(xf_square[i],xf_square[j]);
+		if(shared) swap(shared_index[i],shared_index[j]);
+		if(min(i,j) < prefetch_size && max(i,j) >= prefetch_size)
+			prefetch_size = -1;	// a row not prefetched entered the active set
 	}
+	virtual void set_active_size(int active_size) const;
 protected:
 
 	double (Kernel::*kernel_function)(int i, int j) const;
 
+	// data[j] = K(i,j) for j in [start,len), scaled by y[i]*y[j] if y != NULL
+	void kernel_column(int i, int start, int len, Qfloat *data, const schar *y) const;
+	void kernel_column_float(int i, int start, int len, Qfloat *data, const schar *y) const;
+
+	// set if kernel_column may run in several threads at once; the
+	// scatter layouts then use a buffer per call
+	bool reentrant;
+
 private:
 	const svm_node **x;
 	double *x_square;
+	int nr_thread;
+
+	// if not NULL, kernel_column copies K(x[i],x[j]) from row
+	// shared_index[i] of shared instead of computing it
+	svm_kernel_cache *shared;
+	int *shared_index;
+
+	// out-of-core training (param.active_cache_size > 0): instances are
+	// used where they are, e.g. in a file mapped by svm_load_problem, and
+	// after shrinking rows [0,prefetch_size) of x have been prefetched
+	int x_count;
+	mutable int prefetch_size;
+	size_t prefetch_limit;	// in svm_node, 0 if not out-of-core
+
+	// alternate layouts of x for kernel_column, at most one is non-NULL
+	double **x_dense;	// x_dense[i][k] is feature k of x[i], k < dense_dim
+	double *dense_space;
+	int dense_dim;
+	double *x_scatter;	// all zeros between calls of kernel_column
+	int scatter_dim;
+
+	// the same layouts in single precision, used instead of the above
+	// if param.single_precision is set
+	float **xf_dense;
+	float *xf_dense_space;
+	float *xf_scatter;
+	float *xf_square;
 
 	// svm_parameter
 	const int kernel_type;
@@ -227,7 +432,63 @@ private:
 	const double gamma;
 	const double coef0;
 
+	template <class T> static T *zeros(size_t n)
+	{
+		T *v = new T[n];
+		for(size_t k=0;k<n;k++)
+			v[k] = 0;
+		return v;
+	}
+	template <class T> void dense_layout(int l, int dim, T **&rows, T *&space) const
+	{
+		space = zeros<T>((size_t)l*dim);
+		rows = new T*[l];
+		for(int i=0;i<l;i++)
+		{
+			T *row = &space[(size_t)i*dim];
+			for(const svm_node *p=x[i];p->index != -1;++p)
+				row[p->index] = (T)p->value;
+			rows[i] = row;
+		}
+	}
+
 	static double dot(const svm_node *px, const svm_node *py);
+	static double dense_dot(const double *px, const double *py, int n)
+	{
+		double sum = 0;
+		for(int k=0;k<n;k++)
+			sum += px[k]*py[k];
+		return sum;
+	}
+	static double gather_dot(const double *dense, const svm_node *px)
+	{
+		double sum = 0;
+		for(;px->index != -1;++px)
+			sum += px->value*dense[px->index];
+		return sum;
+	}
+	static float gather_dot_float(const float *dense, const svm_node *px)
+	{
+		float sum = 0;
+		for(;px->index != -1;++px)
+			sum += (float)px->value*dense[px->index];
+		return sum;
+	}
+	// same expressions as kernel_linear, ..., kernel_sigmoid given dot(x[i],x[j])
+	double kernel_from_dot(double d, int i, int j) const
+	{
+		switch(kernel_type)
+		{
+			case POLY:
+				return powi(gamma*d+coef0,degree);
+			case RBF:
+				return exp(-gamma*(x_square[i]+x_square[j]-2*d));
+			case SIGMOID:
+				return tanh(gamma*d+coef0);
+			default:
+				return d;
+		}
+	}
 	double kernel_linear(int i, int j) const
 	{
 		return dot(x[i],x[j]);
@@ -250,7 +511,9 @@ private:
 	}
 };
 
-Kernel::Kernel(int l, svm_node * const * x_, const svm_parameter& param)
+static int svm_kernel_cache_lookup(const svm_kernel_cache *shared, const svm_node *x);
+
+Kernel::Kernel(int l, svm_node * const * x_, const svm_parameter& param, svm_kernel_cache *shared_)
 :kernel_type(param.kernel_type), degree(param.degree),
  gamma(param.gamma), coef0(param.coef0)
 {
@@ -275,6 +538,18 @@ Kernel::Kernel(int l, svm_node * const * x_, const svm_parameter& param)
 
 	clone(x,x_,l);
 
+	x_count = l;
+	prefetch_size = -1;
+	prefetch_limit = 0;
+	if(param.active_cache_size > 0 && kernel_type != PRECOMPUTED && !shared_)
+		prefetch_limit = max((size_t)(param.active_cache_size*(1<<20))/sizeof(svm_node),(size_t)1);
+
+#ifdef _OPENMP
+	nr_thread = (param.nr_thread > 0)? param.nr_thread : omp_get_max_threads();
+#else
+	nr_thread = 1;
+#endif
+
 	if(kernel_type == RBF)
 	{
 		x_square = new double[l];
@@ -283,12 +558,256 @@ Kernel::Kernel(int l, svm_node * const * x_, const svm_parameter& param)
 	}
 	else
 		x_square = 0;
+
+	shared = shared_;
+	shared_index = NULL;
+	if(shared)
+	{
+		shared_index = new int[l];
+		for(int i=0;i<l && shared;i++)
+			if((shared_index[i] = svm_kernel_cache_lookup(shared,x[i])) < 0)
+				shared = NULL;	// not an instance of the cached problem
+	}
+
+	x_dense = NULL;
+	dense_space = NULL;
+	dense_dim = 0;
+	x_scatter = NULL;
+	scatter_dim = 0;
+	reentrant = false;
+	xf_dense = NULL;
+	xf_dense_space = NULL;
+	xf_scatter = NULL;
+	xf_square = NULL;
+	if(kernel_type != PRECOMPUTED && l > 0 && !shared)
+	{
+		int i, min_index = INT_MAX, max_index = -1;
+		bool allow_dense = (prefetch_limit == 0);	// a dense copy would keep all instances in memory
+		double nnz = 0;
+		for(i=0;i<l;i++)
+			for(const svm_node *p=x[i];p->index != -1;++p)
+			{
+				min_index = min(min_index,p->index);
+				max_index = max(max_index,p->index);
+				++nnz;
+			}
+
+		if(min_index >= 0 && max_index < INT_MAX)
+		{
+			int dim = max_index+1;
+			if(allow_dense && (double)l*dim*sizeof(double) <= (nnz+l)*sizeof(svm_node))
+			{
+				dense_dim = dim;
+				if(param.single_precision)
+					dense_layout(l,dim,xf_dense,xf_dense_space);
+				else
+					dense_layout(l,dim,x_dense,dense_space);
+			}
+			else if(dim <= 2*(nnz+l))
+			{
+				scatter_dim = dim;
+				if(param.single_precision)
+					xf_scatter = zeros<float>(dim);
+				else
+					x_scatter = zeros<double>(dim);
+			}
+		}
+	}
+
+	if(x_square && (xf_dense || xf_scatter))
+	{
+		xf_square = new float[l];
+		for(int i=0;i<l;i++)
+			xf_square[i] = (float)x_square[i];
+	}
 }
 
 Kernel::~Kernel()
 {
 	delete[] x;
 	delete[] x_square;
+	delete[] x_dense;
+	delete[] dense_space;
+	delete[] x_scatter;
+	delete[] xf_dense;
+	delete[] xf_dense_space;
+	delete[] xf_scatter;
+	delete[] xf_square;
+	delete[] shared_index;
+}
+
+static int compare_row_address(const void *a, const void *b)
+{
+	const svm_node *pa = *(const svm_node * const *)a;
+	const svm_node *pb = *(const svm_node * const *)b;
+	return (pa < pb)? -1 : (pa > pb)? 1 : 0;
+}
+
+// Ask the OS to prefetch rows [0,n) of x if they fit into
+// active_cache_size, in address order and merging nearby pages, so a
+// mapped file is read sequentially. The rows are used where they are:
+// a copy would keep the active instances in memory twice, once in the
+// copy and once in the pages of the file.
+void Kernel::set_active_size(int n) const
+{
+#if !defined(_WIN32) && defined(MADV_WILLNEED)
+	int i;
+	if(prefetch_limit == 0 || n == prefetch_size)
+		return;
+	prefetch_size = -1;
+	if(n >= x_count)
+		return;
+
+	size_t elements = 0;
+	for(i=0;i<n && elements <= prefetch_limit;i++)
+	{
+		const svm_node *p = x[i];
+		while(p->index != -1)
+			++p;
+		elements += (size_t)(p-x[i]+1);
+	}
+	if(elements > prefetch_limit)
+		return;
+
+	const svm_node **rows = Malloc(const svm_node *,n);
+	memcpy(rows,x,sizeof(const svm_node *)*(size_t)n);
+	qsort(rows,(size_t)n,sizeof(const svm_node *),compare_row_address);
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	uintptr_t begin = 0, end = 0;
+	for(i=0;i<=n;i++)
+	{
+		uintptr_t b = 0, e = 0;
+		if(i < n)
+		{
+			const svm_node *p = rows[i];
+			while(p->index != -1)
+				++p;
+			b = (uintptr_t)rows[i] & ~(uintptr_t)(page-1);
+			e = (uintptr_t)(p+1);
+		}
+		if(i == n || b > end+page)
+		{
+			if(end > begin)
+				madvise((void *)begin,(size_t)(end-begin),MADV_WILLNEED);
+			begin = b;
+		}
+		end = max(end,e);
+	}
+	free(rows);
+	prefetch_size = n;
+#endif
+}
+
+void Kernel::kernel_column(int i, int start, int len, Qfloat *data, const schar *y) const
+{
+	int j;
+	if(shared)
+		shared_kernel_column(shared,shared_index,i,start,len,data,y);
+	else if(xf_dense || xf_scatter)
+		kernel_column_float(i,start,len,data,y);
+	else if(x_dense || x_scatter)
+	{
+		const double *xi;
+		double *scatter = NULL;
+		if(x_dense)
+			xi = x_dense[i];
+		else
+		{
+			scatter = reentrant? zeros<double>(scatter_dim) : x_scatter;
+			for(const svm_node *p=x[i];p->index != -1;++p)
+				scatter[p->index] = p->value;
+			xi = scatter;
+		}
+
+#ifdef _OPENMP
+#pragma omp parallel for private(j) schedule(guided) num_threads(nr_thread) if(len-start >= PARALLEL_COLUMN_MIN)
+#endif
+		for(j=start;j<len;j++)
+		{
+			double d = x_dense? dense_dot(xi,x_dense[j],dense_dim) : gather_dot(xi,x[j]);
+			double k = kernel_from_dot(d,i,j);
+			data[j] = (Qfloat)(y? y[i]*y[j]*k : k);
+		}
+
+		if(scatter == x_scatter && scatter)
+			for(const svm_node *p=x[i];p->index != -1;++p)
+				x_scatter[p->index] = 0;
+		else
+			delete[] scatter;
+	}
+	else if(y)
+	{
+#ifdef _OPENMP
+#pragma omp parallel for private(j) schedule(guided) num_threads(nr_thread) if(len-start >= PARALLEL_COLUMN_MIN)
+#endif
+		for(j=start;j<len;j++)
+			data[j] = (Qfloat)(y[i]*y[j]*(this->*kernel_function)(i,j));
+	}
+	else
+	{
+#ifdef _OPENMP
+#pragma omp parallel for private(j) schedule(guided) num_threads(nr_thread) if(len-start >= PARALLEL_COLUMN_MIN)
+#endif
+		for(j=start;j<len;j++)
+			data[j] = (Qfloat)(this->*kernel_function)(i,j);
+	}
+}
+
+void Kernel::kernel_column_float(int i, int start, int len, Qfloat *data, const schar *y) const
+{
+	int b;
+	int nr_block = (len-start+COLUMN_BLOCK-1)/COLUMN_BLOCK;
+	const float *xi;
+	float *scatter = NULL;
+	if(xf_dense)
+		xi = xf_dense[i];
+	else
+	{
+		scatter = reentrant? zeros<float>(scatter_dim) : xf_scatter;
+		for(const svm_node *p=x[i];p->index != -1;++p)
+			scatter[p->index] = (float)p->value;
+		xi = scatter;
+	}
+
+#ifdef _OPENMP
+#pragma omp parallel for private(b) schedule(dynamic) num_threads(nr_thread) if(len-start >= PARALLEL_COLUMN_MIN)
+#endif
+	for(b=0;b<nr_block;b++)
+	{
+		int begin = start+b*COLUMN_BLOCK;
+		int n = min(len-begin,COLUMN_BLOCK);
+		float *d = &data[begin];
+		int j;
+
+		if(xf_dense)
+			dense_dot_column_float(xi,&xf_dense[begin],dense_dim,d,n);
+		else
+			for(j=0;j<n;j++)
+				d[j] = gather_dot_float(xi,x[begin+j]);
+
+		switch(kernel_type)
+		{
+			case RBF:
+				rbf_column_float(d,&xf_square[begin],xf_square[i],(float)gamma,n);
+				break;
+			case POLY:
+				for(j=0;j<n;j++)
+					d[j] = (float)powi(gamma*d[j]+coef0,degree);
+				break;
+			case SIGMOID:
+				for(j=0;j<n;j++)
+					d[j] = (float)tanh(gamma*d[j]+coef0);
+				break;
+		}
+		if(y)
+			sign_column_float(d,&y[begin],y[i],n);
+	}
+
+	if(scatter == xf_scatter && scatter)
+		for(const svm_node *p=x[i];p->index != -1;++p)
+			xf_scatter[p->index] = 0;
+	else
+		delete[] scatter;
 }
 
 double Kernel::dot(const svm_node *px, const svm_node *py)
@@ -372,6 +891,192 @@ double Kernel::k_function(const svm_node *x, const svm_node *y,
 	}
 }
 
+//
+// Kernel cache shared by svm_train_warm calls
+//
+// Row r holds K(prob->x[r],prob->x[k]) for all k of the problem the cache
+// was created for. Sub-problems whose instances point into prob->x (class
+// pairs, folds of cross validation and probability estimates) are mapped
+// to rows through their x pointers, and since rows are unscaled they stay
+// valid when the labels change. Rows take fixed slots of one arena and
+// are replaced in LRU order. A lock serializes access so that trainings
+// running in parallel may share a cache.
+//
+class Row_Kernel: public Kernel
+{
+public:
+	Row_Kernel(const svm_problem& prob, const svm_parameter& param)
+	:Kernel(prob.l, prob.x, param) { reentrant = true; }
+	Qfloat *get_Q(int column, int len) const { return NULL; }
+	double *get_QD() const { return NULL; }
+	void get_row(int i, int len, Qfloat *data) const { kernel_column(i,0,len,data,NULL); }
+};
+
+struct svm_kernel_cache
+{
+	struct node_index
+	{
+		const svm_node *x;
+		int i;
+	};
+
+	int l;
+	svm_parameter param;	// only the kernel fields are used
+	Row_Kernel *kernel;
+	node_index *sorted;	// prob->x sorted by address
+	int nr_slot, nr_used;
+	Qfloat *arena;		// nr_slot rows of length l
+	int *slot_of;		// slot of row r, -1 if not cached
+	int *row_of;		// row held by slot s
+	int *prev, *next;	// circular LRU list of slots, nr_slot is the head
+	int *pin;		// users of slot s; pinned slots are not evicted
+	char *ready;		// whether slot s holds its row yet
+	long int nr_hit, nr_miss;
+#ifdef _OPENMP
+	omp_lock_t lock;	// guards the fields above, not the arena
+	omp_lock_t *fill;	// held by the thread computing the row of slot s
+#endif
+};
+
+static int compare_node_index(const void *a, const void *b)
+{
+	const svm_node *xa = ((const svm_kernel_cache::node_index *)a)->x;
+	const svm_node *xb = ((const svm_kernel_cache::node_index *)b)->x;
+	return (xa < xb)? -1 : (xa > xb)? 1 : 0;
+}
+
+// row of x in the cached problem, or -1
+static int svm_kernel_cache_lookup(const svm_kernel_cache *shared, const svm_node *x)
+{
+	int low = 0, high = shared->l-1;
+	while(low <= high)
+	{
+		int mid = (low+high)/2;
+		const svm_node *xm = shared->sorted[mid].x;
+		if(xm == x)
+			return shared->sorted[mid].i;
+		else if(xm < x)
+			low = mid+1;
+		else
+			high = mid-1;
+	}
+	return -1;
+}
+
+static void shared_kernel_column(svm_kernel_cache *shared, const int *index,
+	int i, int start, int len, Qfloat *data, const schar *y)
+{
+	// The lock is only held to find or reserve a slot; rows are computed
+	// and copied outside it, with the slot pinned so it is not evicted.
+	int r = index[i];
+	int head = shared->nr_slot;
+	bool fill = false, ready = true;
+#ifdef _OPENMP
+	omp_set_lock(&shared->lock);
+#endif
+	int s = shared->slot_of[r];
+	if(s >= 0)
+	{
+		++shared->nr_hit;
+		ready = shared->ready[s] != 0;
+		shared->prev[shared->next[s]] = shared->prev[s];
+		shared->next[shared->prev[s]] = shared->next[s];
+	}
+	else
+	{
+		++shared->nr_miss;
+		if(shared->nr_used < shared->nr_slot)
+			s = shared->nr_used++;
+		else
+		{
+			// least recently used slot that nobody is using
+			for(s=shared->next[head];s!=head && shared->pin[s]>0;s=shared->next[s]);
+			if(s == head)
+				s = -1;
+			else
+			{
+				shared->prev[shared->next[s]] = shared->prev[s];
+				shared->next[shared->prev[s]] = shared->next[s];
+				shared->slot_of[shared->row_of[s]] = -1;
+			}
+		}
+		if(s >= 0)
+		{
+			shared->slot_of[r] = s;
+			shared->row_of[s] = r;
+			shared->ready[s] = 0;
+			fill = true;
+#ifdef _OPENMP
+			omp_set_lock(&shared->fill[s]);
+#endif
+		}
+	}
+	if(s >= 0)
+	{
+		++shared->pin[s];
+		// move s to the most recently used end
+		shared->next[s] = head;
+		shared->prev[s] = shared->prev[head];
+		shared->next[shared->prev[head]] = s;
+		shared->prev[head] = s;
+	}
+#ifdef _OPENMP
+	omp_unset_lock(&shared->lock);
+#endif
+
+	Qfloat *row;
+	if(s < 0)
+	{
+		// every slot is in use: compute the row without caching it
+		row = Malloc(Qfloat,shared->l);
+		shared->kernel->get_row(r,shared->l,row);
+	}
+	else
+	{
+		row = &shared->arena[(size_t)s*shared->l];
+		if(fill)
+		{
+			shared->kernel->get_row(r,shared->l,row);
+#ifdef _OPENMP
+			omp_set_lock(&shared->lock);
+#endif
+			shared->ready[s] = 1;
+#ifdef _OPENMP
+			omp_unset_lock(&shared->lock);
+			omp_unset_lock(&shared->fill[s]);
+#endif
+		}
+#ifdef _OPENMP
+		else if(!ready)
+		{
+			// wait for the thread computing the row
+			omp_set_lock(&shared->fill[s]);
+			omp_unset_lock(&shared->fill[s]);
+		}
+#endif
+	}
+
+	if(y)
+		for(int j=start;j<len;j++)
+			data[j] = (Qfloat)(y[i]*y[j])*row[index[j]];
+	else
+		for(int j=start;j<len;j++)
+			data[j] = row[index[j]];
+
+	if(s < 0)
+		free(row);
+	else
+	{
+#ifdef _OPENMP
+		omp_set_lock(&shared->lock);
+#endif
+		--shared->pin[s];
+#ifdef _OPENMP
+		omp_unset_lock(&shared->lock);
+#endif
+	}
+}
+
 // An SMO algorithm in Fan et al., JMLR 6(2005), p. 1889--1918
 // Solves:
 //
@@ -390,6 +1095,57 @@ double Kernel::k_function(const svm_node *x, const svm_node *y,
 //
 // solution will be put in \alpha, objective value will be put in obj
 //
+// The O(active_size) passes of select_working_set work on blocks of
+// SELECT_BLOCK variables: the candidate values of a block are computed
+// into a buffer without branches (-INF for variables that are not
+// candidates) and reduced with SIMD, and only a block reaching the
+// running maximum is searched backwards. This picks the last index
+// attaining the maximum, as the scalar loops updating on >= do. From
+// PARALLEL_SOLVER_MIN variables on, the passes and the gradient update
+// are split into contiguous ranges for nr_thread threads and results
+// are merged in order, so the working sets and the solution do not
+// depend on the ISA or nr_thread.
+//
+#define SELECT_BLOCK 256
+#define PARALLEL_SOLVER_MIN 100000
+#if defined(_OPENMP) && _OPENMP >= 201307
+#define PRAGMA_SIMD_MAX _Pragma("omp simd reduction(max:vmax)")
+#define PRAGMA_SIMD_MAX2 _Pragma("omp simd reduction(max:vmax,ymax)")
+#else
+#define PRAGMA_SIMD_MAX
+#define PRAGMA_SIMD_MAX2
+#endif
+
+// G[k] += Q_i[k]*delta_alpha_i + Q_j[k]*delta_alpha_j for k in [start,end)
+SIMD_CLONES_EXACT
+static void update_gradient(double *G, const Qfloat *Q_i, const Qfloat *Q_j,
+	double delta_alpha_i, double delta_alpha_j, int start, int end)
+{
+	for(int k=start;k<end;k++)
+		G[k] += Q_i[k]*delta_alpha_i + Q_j[k]*delta_alpha_j;
+}
+
+struct select_result
+{
+	double max;	// largest candidate value, -INF if none
+	int index;	// last index attaining max, -1 if none
+	double Gmax2;	// second pass: max { y_j*grad(f)_j | j in I_low(\alpha) }
+};
+
+// merge v[0,n), the values of variables start..start+n-1 with
+// maximum vmax, into r
+static inline void select_block_max(const double *v, int start, int n, double vmax, select_result& r)
+{
+	if(vmax > -INF && vmax >= r.max)
+	{
+		int k = n-1;
+		while(v[k] != vmax)
+			--k;
+		r.max = vmax;
+		r.index = start+k;
+	}
+}
+
 class Solver {
 public:
 	Solver() {};
@@ -405,7 +1161,7 @@ public:
 
 	void Solve(int l, const QMatrix& Q, const double *p_, const schar *y_,
 		   double *alpha_, double Cp, double Cn, double eps,
-		   SolutionInfo* si, int shrinking);
+		   SolutionInfo* si, int shrinking, int nr_thread);
 protected:
 	int active_size;
 	schar *y;
@@ -422,6 +1178,8 @@ protected:
 	double *G_bar;		// gradient, if we treat free variables as 0
 	int l;
 	bool unshrink;	// XXX
+	int nr_thread;
+	select_result *select_part;	// per thread results of a selection pass
 
 	double get_C(int i)
 	{
@@ -445,6 +1203,12 @@ protected:
 	virtual void do_shrinking();
 private:
 	bool be_shrunk(int i, double Gmax1, double Gmax2);
+	int nr_range(int n) const;
+	void select_range(int start, int end, int i, const Qfloat *Q_i, double Gmax, select_result& r) const;
+	void select_pass(int i, const Qfloat *Q_i, double Gmax, select_result& r) const;
+	static double select_up_values(int n, const schar *y, const char *alpha_status, const double *G, double *v);
+	static double select_low_values(int n, const schar *y, const char *alpha_status, const double *G,
+		const double *QD, const Qfloat *Q_i, double QD_i, double two_y_i, double Gmax, double *v, double& Gmax2);
 };
 
 void Solver::swap_index(int i, int j)
@@ -503,7 +1267,7 @@ void Solver::reconstruct_gradient()
 
 void Solver::Solve(int l, const QMatrix& Q, const double *p_, const schar *y_,
 		   double *alpha_, double Cp, double Cn, double eps,
-		   SolutionInfo* si, int shrinking)
+		   SolutionInfo* si, int shrinking, int nr_thread)
 {
 	this->l = l;
 	this->Q = &Q;
@@ -515,6 +1279,12 @@ void Solver::Solve(int l, const QMatrix& Q, const double *p_, const schar *y_,
 	this->Cn = Cn;
 	this->eps = eps;
 	unshrink = false;
+#ifdef _OPENMP
+	this->nr_thread = (nr_thread > 0)? nr_thread : omp_get_max_threads();
+#else
+	this->nr_thread = 1;
+#endif
+	select_part = new select_result[this->nr_thread];
 
 	// initialize alpha_status
 	{
@@ -691,9 +1461,18 @@ void Solver::Solve(int l, const QMatrix& Q, const double *p_, const schar *y_,
 		double delta_alpha_i = alpha[i] - old_alpha_i;
 		double delta_alpha_j = alpha[j] - old_alpha_j;
 		
-		for(int k=0;k<active_size;k++)
+		int nr_part = nr_range(active_size);
+		if(nr_part == 1)
+			update_gradient(G,Q_i,Q_j,delta_alpha_i,delta_alpha_j,0,active_size);
+		else
 		{
-			G[k] += Q_i[k]*delta_alpha_i + Q_j[k]*delta_alpha_j;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nr_part)
+#endif
+			for(int t=0;t<nr_part;t++)
+				update_gradient(G,Q_i,Q_j,delta_alpha_i,delta_alpha_j,
+					(int)((long long)active_size*t/nr_part),
+					(int)((long long)active_size*(t+1)/nr_part));
 		}
 
 		// update alpha_status and G_bar
@@ -780,105 +1559,135 @@ void Solver::Solve(int l, const QMatrix& Q, const double *p_, const schar *y_,
 	delete[] active_set;
 	delete[] G;
 	delete[] G_bar;
+	delete[] select_part;
 }
 
-// return 1 if already optimal, return 0 otherwise
-int Solver::select_working_set(int &out_i, int &out_j)
+// number of threads for a pass over n variables
+int Solver::nr_range(int n) const
 {
-	// return i,j such that
-	// i: maximizes -y_i * grad(f)_i, i in I_up(\alpha)
-	// j: minimizes the decrease of obj value
-	//    (if quadratic coefficeint <= 0, replace it with tau)
-	//    -y_j*grad(f)_j < -y_i*grad(f)_i, j in I_low(\alpha)
-	
-	double Gmax = -INF;
-	double Gmax2 = -INF;
-	int Gmax_idx = -1;
-	int Gmin_idx = -1;
-	double obj_diff_min = INF;
+	return (n >= PARALLEL_SOLVER_MIN)? min(nr_thread,n/SELECT_BLOCK) : 1;
+}
 
-	for(int t=0;t<active_size;t++)
-		if(y[t]==+1)	
-		{
-			if(!is_upper_bound(t))
-				if(-G[t] >= Gmax)
-				{
-					Gmax = -G[t];
-					Gmax_idx = t;
-				}
-		}
-		else
-		{
-			if(!is_lower_bound(t))
-				if(G[t] >= Gmax)
-				{
-					Gmax = G[t];
-					Gmax_idx = t;
-				}
-		}
-
-	int i = Gmax_idx;
-	const Qfloat *Q_i = NULL;
-	if(i != -1) // NULL Q_i not accessed: Gmax=-INF if i=-1
-		Q_i = Q->get_Q(i,active_size);
+// v[k] = -y_k*grad(f)_k if k in I_up(\alpha), -INF otherwise;
+// returns the maximum of v
+SIMD_CLONES_EXACT
+double Solver::select_up_values(int n, const schar *y, const char *alpha_status, const double *G, double *v)
+{
+	double vmax = -INF;
+	PRAGMA_SIMD_MAX
+	for(int k=0;k<n;k++)
+	{
+		char bound = (y[k] == +1)? UPPER_BOUND : LOWER_BOUND;
+		double value = (alpha_status[k] != bound)? -y[k]*G[k] : -INF;
+		v[k] = value;
+		vmax = max(vmax,value);
+	}
+	return vmax;
+}
 
-	for(int j=0;j<active_size;j++)
+// v[k] = b^2/a, minus the objective decrease for j = k, if k in
+// I_low(\alpha) and b = -y_i*grad(f)_i + y_k*grad(f)_k > 0, -INF
+// otherwise; returns the maximum of v and merges
+// max { y_k*grad(f)_k | k in I_low(\alpha) } into Gmax2
+SIMD_CLONES_EXACT
+double Solver::select_low_values(int n, const schar *y, const char *alpha_status, const double *G,
+	const double *QD, const Qfloat *Q_i, double QD_i, double two_y_i, double Gmax, double *v, double& Gmax2)
+{
+	double vmax = -INF, ymax = Gmax2;
+	PRAGMA_SIMD_MAX2
+	for(int k=0;k<n;k++)
 	{
-		if(y[j]==+1)
-		{
-			if (!is_lower_bound(j))
-			{
-				double grad_diff=Gmax+G[j];
-				if (G[j] >= Gmax2)
-					Gmax2 = G[j];
-				if (grad_diff > 0)
-				{
-					double obj_diff;
-					double quad_coef = QD[i]+QD[j]-2.0*y[i]*Q_i[j];
-					if (quad_coef > 0)
-						obj_diff = -(grad_diff*grad_diff)/quad_coef;
-					else
-						obj_diff = -(grad_diff*grad_diff)/TAU;
+		char bound = (y[k] == +1)? LOWER_BOUND : UPPER_BOUND;
+		bool low = (alpha_status[k] != bound);
+		double yG = y[k]*G[k];
+		double grad_diff = Gmax+yG;
+		double quad_coef = QD_i+QD[k]-(two_y_i*Q_i[k])*y[k];
+		if(!(quad_coef > 0))
+			quad_coef = TAU;
+		double value = (low && grad_diff > 0)? (grad_diff*grad_diff)/quad_coef : -INF;
+		v[k] = value;
+		vmax = max(vmax,value);
+		ymax = low? max(ymax,yG) : ymax;
+	}
+	Gmax2 = ymax;
+	return vmax;
+}
 
-					if (obj_diff <= obj_diff_min)
-					{
-						Gmin_idx=j;
-						obj_diff_min = obj_diff;
-					}
-				}
-			}
-		}
+// the first pass (Q_i == NULL) or second pass of select_working_set
+// over variables [start,end)
+void Solver::select_range(int start, int end, int i, const Qfloat *Q_i, double Gmax, select_result& r) const
+{
+	double v[SELECT_BLOCK];
+	r.max = -INF;
+	r.index = -1;
+	r.Gmax2 = -INF;
+	for(int s=start;s<end;s+=SELECT_BLOCK)
+	{
+		int n = min(end-s,SELECT_BLOCK);
+		double vmax;
+		if(Q_i == NULL)
+			vmax = select_up_values(n,y+s,alpha_status+s,G+s,v);
 		else
-		{
-			if (!is_upper_bound(j))
-			{
-				double grad_diff= Gmax-G[j];
-				if (-G[j] >= Gmax2)
-					Gmax2 = -G[j];
-				if (grad_diff > 0)
-				{
-					double obj_diff;
-					double quad_coef = QD[i]+QD[j]+2.0*y[i]*Q_i[j];
-					if (quad_coef > 0)
-						obj_diff = -(grad_diff*grad_diff)/quad_coef;
-					else
-						obj_diff = -(grad_diff*grad_diff)/TAU;
+			vmax = select_low_values(n,y+s,alpha_status+s,G+s,
+				QD+s,Q_i+s,QD[i],2.0*y[i],Gmax,v,r.Gmax2);
+		select_block_max(v,s,n,vmax,r);
+	}
+}
 
-					if (obj_diff <= obj_diff_min)
-					{
-						Gmin_idx=j;
-						obj_diff_min = obj_diff;
-					}
-				}
-			}
+void Solver::select_pass(int i, const Qfloat *Q_i, double Gmax, select_result& r) const
+{
+	int nr_part = nr_range(active_size);
+	if(nr_part == 1)
+	{
+		select_range(0,active_size,i,Q_i,Gmax,r);
+		return;
+	}
+
+	int nr_block = (active_size+SELECT_BLOCK-1)/SELECT_BLOCK;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(nr_part)
+#endif
+	for(int t=0;t<nr_part;t++)
+		select_range((int)((long long)nr_block*t/nr_part)*SELECT_BLOCK,
+			min((int)((long long)nr_block*(t+1)/nr_part)*SELECT_BLOCK,active_size),
+			i,Q_i,Gmax,select_part[t]);
+
+	r = select_part[0];
+	for(int t=1;t<nr_part;t++)
+	{
+		if(select_part[t].index != -1 && select_part[t].max >= r.max)
+		{
+			r.max = select_part[t].max;
+			r.index = select_part[t].index;
 		}
+		r.Gmax2 = max(r.Gmax2,select_part[t].Gmax2);
 	}
+}
+
+// return 1 if already optimal, return 0 otherwise
+int Solver::select_working_set(int &out_i, int &out_j)
+{
+	// return i,j such that
+	// i: maximizes -y_i * grad(f)_i, i in I_up(\alpha)
+	// j: minimizes the decrease of obj value
+	//    (if quadratic coefficeint <= 0, replace it with tau)
+	//    -y_j*grad(f)_j < -y_i*grad(f)_i, j in I_low(\alpha)
+
+	select_result up, low;
+	select_pass(-1,NULL,0,up);
 
-	if(Gmax+Gmax2 < eps || Gmin_idx == -1)
+	double Gmax = up.max;
+	int i = up.index;
+	if(i == -1) // no j can decrease the obj value: Gmax=-INF
 		return 1;
+	const Qfloat *Q_i = Q->get_Q(i,active_size);
+	select_pass(i,Q_i,Gmax,low);
 
-	out_i = Gmax_idx;
-	out_j = Gmin_idx;
+	if(Gmax+low.Gmax2 < eps || low.index == -1)
+		return 1;
+
+	out_i = i;
+	out_j = low.index;
 	return 0;
 }
 
@@ -961,6 +1770,7 @@ void Solver::do_shrinking()
 				active_size--;
 			}
 		}
+	Q->set_active_size(active_size);
 }
 
 double Solver::calculate_rho()
@@ -1012,10 +1822,10 @@ public:
 	Solver_NU() {}
 	void Solve(int l, const QMatrix& Q, const double *p, const schar *y,
 		   double *alpha, double Cp, double Cn, double eps,
-		   SolutionInfo* si, int shrinking)
+		   SolutionInfo* si, int shrinking, int nr_thread)
 	{
 		this->si = si;
-		Solver::Solve(l,Q,p,y,alpha,Cp,Cn,eps,si,shrinking);
+		Solver::Solve(l,Q,p,y,alpha,Cp,Cn,eps,si,shrinking,nr_thread);
 	}
 private:
 	SolutionInfo *si;
@@ -1208,6 +2018,7 @@ void Solver_NU::do_shrinking()
 				active_size--;
 			}
 		}
+	Q->set_active_size(active_size);
 }
 
 double Solver_NU::calculate_rho()
@@ -1266,8 +2077,8 @@ double Solver_NU::calculate_rho()
 class SVC_Q: public Kernel
 { 
 public:
-	SVC_Q(const svm_problem& prob, const svm_parameter& param, const schar *y_)
-	:Kernel(prob.l, prob.x, param)
+	SVC_Q(const svm_problem& prob, const svm_parameter& param, const schar *y_, svm_kernel_cache *shared)
+	:Kernel(prob.l, prob.x, param, shared)
 	{
 		clone(y,y_,prob.l);
 		cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)));
@@ -1279,12 +2090,9 @@ public:
 	Qfloat *get_Q(int i, int len) const
 	{
 		Qfloat *data;
-		int start, j;
+		int start;
 		if((start = cache->get_data(i,&data,len)) < len)
-		{
-			for(j=start;j<len;j++)
-				data[j] = (Qfloat)(y[i]*y[j]*(this->*kernel_function)(i,j));
-		}
+			kernel_column(i,start,len,data,y);
 		return data;
 	}
 
@@ -1316,8 +2124,8 @@ private:
 class ONE_CLASS_Q: public Kernel
 {
 public:
-	ONE_CLASS_Q(const svm_problem& prob, const svm_parameter& param)
-	:Kernel(prob.l, prob.x, param)
+	ONE_CLASS_Q(const svm_problem& prob, const svm_parameter& param, svm_kernel_cache *shared)
+	:Kernel(prob.l, prob.x, param, shared)
 	{
 		cache = new Cache(prob.l,(long int)(param.cache_size*(1<<20)));
 		QD = new double[prob.l];
@@ -1328,12 +2136,9 @@ public:
 	Qfloat *get_Q(int i, int len) const
 	{
 		Qfloat *data;
-		int start, j;
+		int start;
 		if((start = cache->get_data(i,&data,len)) < len)
-		{
-			for(j=start;j<len;j++)
-				data[j] = (Qfloat)(this->*kernel_function)(i,j);
-		}
+			kernel_column(i,start,len,data,NULL);
 		return data;
 	}
 
@@ -1362,8 +2167,8 @@ private:
 class SVR_Q: public Kernel
 { 
 public:
-	SVR_Q(const svm_problem& prob, const svm_parameter& param)
-	:Kernel(prob.l, prob.x, param)
+	SVR_Q(const svm_problem& prob, const svm_parameter& param, svm_kernel_cache *shared)
+	:Kernel(prob.l, prob.x, param, shared)
 	{
 		l = prob.l;
 		cache = new Cache(l,(long int)(param.cache_size*(1<<20)));
@@ -1390,16 +2195,16 @@ public:
 		swap(index[i],index[j]);
 		swap(QD[i],QD[j]);
 	}
+
+	// each column spans all l instances, so none of them can be released
+	void set_active_size(int active_size) const {}
 	
 	Qfloat *get_Q(int i, int len) const
 	{
 		Qfloat *data;
 		int j, real_i = index[i];
 		if(cache->get_data(real_i,&data,l) < l)
-		{
-			for(j=0;j<l;j++)
-				data[j] = (Qfloat)(this->*kernel_function)(real_i,j);
-		}
+			kernel_column(real_i,0,l,data,NULL);
 
 		// reorder and copy
 		Qfloat *buf = buffer[next_buffer];
@@ -1439,7 +2244,8 @@ private:
 //
 static void solve_c_svc(
 	const svm_problem *prob, const svm_parameter* param,
-	double *alpha, Solver::SolutionInfo* si, double Cp, double Cn)
+	double *alpha, Solver::SolutionInfo* si, double Cp, double Cn,
+	const double *init_alpha, svm_kernel_cache *shared)
 {
 	int l = prob->l;
 	double *minus_ones = new double[l];
@@ -1454,9 +2260,26 @@ static void solve_c_svc(
 		if(prob->y[i] > 0) y[i] = +1; else y[i] = -1;
 	}
 
+	if(init_alpha)
+	{
+		// clip to the new bounds, then restore y'alpha = 0 by scaling
+		// down the side with the larger sum
+		double sum_p = 0, sum_n = 0;
+		for(i=0;i<l;i++)
+		{
+			alpha[i] = min(max(init_alpha[i],0.0),(y[i] > 0)? Cp : Cn);
+			if(y[i] > 0) sum_p += alpha[i]; else sum_n += alpha[i];
+		}
+		for(i=0;i<l;i++)
+			if(y[i] > 0 && sum_p > sum_n)
+				alpha[i] *= sum_n/sum_p;
+			else if(y[i] < 0 && sum_n > sum_p)
+				alpha[i] *= sum_p/sum_n;
+	}
+
 	Solver s;
-	s.Solve(l, SVC_Q(*prob,*param,y), minus_ones, y,
-		alpha, Cp, Cn, param->eps, si, param->shrinking);
+	s.Solve(l, SVC_Q(*prob,*param,y,shared), minus_ones, y,
+		alpha, Cp, Cn, param->eps, si, param->shrinking, param->nr_thread);
 
 	double sum_alpha=0;
 	for(i=0;i<l;i++)
@@ -1474,7 +2297,7 @@ static void solve_c_svc(
 
 static void solve_nu_svc(
 	const svm_problem *prob, const svm_parameter *param,
-	double *alpha, Solver::SolutionInfo* si)
+	double *alpha, Solver::SolutionInfo* si, svm_kernel_cache *shared)
 {
 	int i;
 	int l = prob->l;
@@ -1509,8 +2332,8 @@ static void solve_nu_svc(
 		zeros[i] = 0;
 
 	Solver_NU s;
-	s.Solve(l, SVC_Q(*prob,*param,y), zeros, y,
-		alpha, 1.0, 1.0, param->eps, si,  param->shrinking);
+	s.Solve(l, SVC_Q(*prob,*param,y,shared), zeros, y,
+		alpha, 1.0, 1.0, param->eps, si,  param->shrinking, param->nr_thread);
 	double r = si->r;
 
 	info("C = %f\n",1/r);
@@ -1529,7 +2352,7 @@ static void solve_nu_svc(
 
 static void solve_one_class(
 	const svm_problem *prob, const svm_parameter *param,
-	double *alpha, Solver::SolutionInfo* si)
+	double *alpha, Solver::SolutionInfo* si, svm_kernel_cache *shared)
 {
 	int l = prob->l;
 	double *zeros = new double[l];
@@ -1552,8 +2375,8 @@ static void solve_one_class(
 	}
 
 	Solver s;
-	s.Solve(l, ONE_CLASS_Q(*prob,*param), zeros, ones,
-		alpha, 1.0, 1.0, param->eps, si, param->shrinking);
+	s.Solve(l, ONE_CLASS_Q(*prob,*param,shared), zeros, ones,
+		alpha, 1.0, 1.0, param->eps, si, param->shrinking, param->nr_thread);
 
 	delete[] zeros;
 	delete[] ones;
@@ -1561,7 +2384,7 @@ static void solve_one_class(
 
 static void solve_epsilon_svr(
 	const svm_problem *prob, const svm_parameter *param,
-	double *alpha, Solver::SolutionInfo* si)
+	double *alpha, Solver::SolutionInfo* si, svm_kernel_cache *shared)
 {
 	int l = prob->l;
 	double *alpha2 = new double[2*l];
@@ -1581,8 +2404,8 @@ static void solve_epsilon_svr(
 	}
 
 	Solver s;
-	s.Solve(2*l, SVR_Q(*prob,*param), linear_term, y,
-		alpha2, param->C, param->C, param->eps, si, param->shrinking);
+	s.Solve(2*l, SVR_Q(*prob,*param,shared), linear_term, y,
+		alpha2, param->C, param->C, param->eps, si, param->shrinking, param->nr_thread);
 
 	double sum_alpha = 0;
 	for(i=0;i<l;i++)
@@ -1599,7 +2422,7 @@ static void solve_epsilon_svr(
 
 static void solve_nu_svr(
 	const svm_problem *prob, const svm_parameter *param,
-	double *alpha, Solver::SolutionInfo* si)
+	double *alpha, Solver::SolutionInfo* si, svm_kernel_cache *shared)
 {
 	int l = prob->l;
 	double C = param->C;
@@ -1622,8 +2445,8 @@ static void solve_nu_svr(
 	}
 
 	Solver_NU s;
-	s.Solve(2*l, SVR_Q(*prob,*param), linear_term, y,
-		alpha2, C, C, param->eps, si, param->shrinking);
+	s.Solve(2*l, SVR_Q(*prob,*param,shared), linear_term, y,
+		alpha2, C, C, param->eps, si, param->shrinking, param->nr_thread);
 
 	info("epsilon = %f\n",-si->r);
 
@@ -1644,28 +2467,29 @@ struct decision_function
 	double rho;
 };
 
+// init_alpha is the starting point of C_SVC (NULL for alpha = 0)
 static decision_function svm_train_one(
 	const svm_problem *prob, const svm_parameter *param,
-	double Cp, double Cn)
+	double Cp, double Cn, const double *init_alpha, svm_kernel_cache *shared)
 {
 	double *alpha = Malloc(double,prob->l);
 	Solver::SolutionInfo si;
 	switch(param->svm_type)
 	{
 		case C_SVC:
-			solve_c_svc(prob,param,alpha,&si,Cp,Cn);
+			solve_c_svc(prob,param,alpha,&si,Cp,Cn,init_alpha,shared);
 			break;
 		case NU_SVC:
-			solve_nu_svc(prob,param,alpha,&si);
+			solve_nu_svc(prob,param,alpha,&si,shared);
 			break;
 		case ONE_CLASS:
-			solve_one_class(prob,param,alpha,&si);
+			solve_one_class(prob,param,alpha,&si,shared);
 			break;
 		case EPSILON_SVR:
-			solve_epsilon_svr(prob,param,alpha,&si);
+			solve_epsilon_svr(prob,param,alpha,&si,shared);
 			break;
 		case NU_SVR:
-			solve_nu_svr(prob,param,alpha,&si);
+			solve_nu_svr(prob,param,alpha,&si,shared);
 			break;
 	}
 
@@ -1889,10 +2713,14 @@ static void multiclass_probability(int k, double **r, double *p)
 	free(Qp);
 }
 
-// Cross-validation decision values for probability estimates
+static int svm_cross_validation_workers(const svm_parameter *param, int nr_fold);
+
+// Cross-validation decision values for probability estimates. Only the
+// shuffle draws from rand(), so the folds are trained in parallel as in
+// svm_cross_validation.
 static void svm_binary_svc_probability(
 	const svm_problem *prob, const svm_parameter *param,
-	double Cp, double Cn, double& probA, double& probB)
+	double Cp, double Cn, double& probA, double& probB, svm_kernel_cache *shared)
 {
 	int i;
 	int nr_fold = 5;
@@ -1906,6 +2734,22 @@ static void svm_binary_svc_probability(
 		int j = i+rand()%(prob->l-i);
 		swap(perm[i],perm[j]);
 	}
+
+	svm_parameter subparam = *param;
+	subparam.probability=0;
+	subparam.C=1.0;
+	subparam.nr_weight=2;
+	subparam.weight_label = Malloc(int,2);
+	subparam.weight = Malloc(double,2);
+	subparam.weight_label[0]=+1;
+	subparam.weight_label[1]=-1;
+	subparam.weight[0]=Cp;
+	subparam.weight[1]=Cn;
+	int nr_worker = svm_cross_validation_workers(&subparam,nr_fold);
+	subparam.cache_size = param->cache_size/nr_worker;
+#ifdef _OPENMP
+#pragma omp parallel for private(i) schedule(dynamic) num_threads(nr_worker) if(nr_worker > 1)
+#endif
 	for(i=0;i<nr_fold;i++)
 	{
 		int begin = i*prob->l/nr_fold;
@@ -1948,17 +2792,7 @@ static void svm_binary_svc_probability(
 				dec_values[perm[j]] = -1;
 		else
 		{
-			svm_parameter subparam = *param;
-			subparam.probability=0;
-			subparam.C=1.0;
-			subparam.nr_weight=2;
-			subparam.weight_label = Malloc(int,2);
-			subparam.weight = Malloc(double,2);
-			subparam.weight_label[0]=+1;
-			subparam.weight_label[1]=-1;
-			subparam.weight[0]=Cp;
-			subparam.weight[1]=Cn;
-			struct svm_model *submodel = svm_train(&subprob,&subparam);
+			struct svm_model *submodel = svm_train_warm(&subprob,&subparam,NULL,shared);
 			for(j=begin;j<end;j++)
 			{
 				svm_predict_values(submodel,prob->x[perm[j]],&(dec_values[perm[j]]));
@@ -1966,31 +2800,27 @@ static void svm_binary_svc_probability(
 				dec_values[perm[j]] *= submodel->label[0];
 			}		
 			svm_free_and_destroy_model(&submodel);
-			svm_destroy_param(&subparam);
 		}
 		free(subprob.x);
 		free(subprob.y);
 	}		
+	svm_destroy_param(&subparam);
 	sigmoid_train(prob->l,dec_values,prob->y,probA,probB);
 	free(dec_values);
 	free(perm);
 }
 
-// Return parameter of a Laplace distribution 
-static double svm_svr_probability(
-	const svm_problem *prob, const svm_parameter *param)
+// Laplace scale of the residuals of out-of-fold predictions target,
+// ignoring residuals larger than 5 standard deviations
+static double svm_svr_laplace_scale(const svm_problem *prob, const double *target)
 {
 	int i;
-	int nr_fold = 5;
 	double *ymv = Malloc(double,prob->l);
 	double mae = 0;
 
-	svm_parameter newparam = *param;
-	newparam.probability = 0;
-	svm_cross_validation(prob,&newparam,nr_fold,ymv);
 	for(i=0;i<prob->l;i++)
 	{
-		ymv[i]=prob->y[i]-ymv[i];
+		ymv[i]=prob->y[i]-target[i];
 		mae += fabs(ymv[i]);
 	}		
 	mae /= prob->l;
@@ -2008,6 +2838,21 @@ static double svm_svr_probability(
 	return mae;
 }
 
+// Return parameter of a Laplace distribution 
+static double svm_svr_probability(
+	const svm_problem *prob, const svm_parameter *param)
+{
+	int nr_fold = 5;
+	double *ymv = Malloc(double,prob->l);
+
+	svm_parameter newparam = *param;
+	newparam.probability = 0;
+	svm_cross_validation(prob,&newparam,nr_fold,ymv);
+	double sigma = svm_svr_laplace_scale(prob,ymv);
+	free(ymv);
+	return sigma;
+}
+
 
 // label: label name, start: begin of each class, count: #data of classes, perm: indices to the original data
 // perm, length l, must be allocated before calling this subroutine
@@ -2086,14 +2931,137 @@ static void svm_group_classes(const svm_problem *prob, int *nr_class_ret, int **
 	free(data_label);
 }
 
+// For the linear kernel, decision function p is w_p'x - rho[p] with
+// w_p = sum of sv_coef*SV over its SVs, so prediction needs one sparse
+// dot product per decision function instead of one per SV. The w_p
+// are stored densely, and only if that takes no more memory than the
+// SVs. Decision values may differ from the SV sums in the last bits.
+static void svm_collapse_linear(svm_model *model)
+{
+	int i, k;
+	int l = model->l;
+	int nr_class = model->nr_class;
+	int svm_type = model->param.svm_type;
+	model->w = NULL;
+	model->w_dim = 0;
+	if(model->param.kernel_type != LINEAR || l == 0)
+		return;
+
+	double nnz = 0;
+	int max_index = -1;
+	for(i=0;i<l;i++)
+		for(const svm_node *p=model->SV[i];p->index != -1;++p)
+		{
+			if(p->index < 0)
+				return;
+			max_index = max(max_index,p->index);
+			++nnz;
+		}
+
+	bool is_svc = !(svm_type == ONE_CLASS || svm_type == EPSILON_SVR || svm_type == NU_SVR);
+	int nr_dec = is_svc? nr_class*(nr_class-1)/2 : 1;
+	int dim = max_index+1;
+	if(dim == 0 || (double)nr_dec*dim*sizeof(double) > (nnz+l)*sizeof(svm_node))
+		return;
+
+	model->w_dim = dim;
+	model->w = Malloc(double *,nr_dec);
+	for(k=0;k<nr_dec;k++)
+	{
+		model->w[k] = Malloc(double,dim);
+		for(i=0;i<dim;i++)
+			model->w[k][i] = 0;
+	}
+
+	if(!is_svc)
+	{
+		for(i=0;i<l;i++)
+			for(const svm_node *p=model->SV[i];p->index != -1;++p)
+				model->w[0][p->index] += model->sv_coef[0][i]*p->value;
+		return;
+	}
+
+	int *start = Malloc(int,nr_class);
+	start[0] = 0;
+	for(i=1;i<nr_class;i++)
+		start[i] = start[i-1]+model->nSV[i-1];
+
+	int q = 0;
+	for(i=0;i<nr_class;i++)
+		for(int j=i+1;j<nr_class;j++)
+		{
+			// same coefficients as in svc_predict_kvalue
+			double *w = model->w[q++];
+			for(k=start[i];k<start[i]+model->nSV[i];k++)
+				for(const svm_node *p=model->SV[k];p->index != -1;++p)
+					w[p->index] += model->sv_coef[j-1][k]*p->value;
+			for(k=start[j];k<start[j]+model->nSV[j];k++)
+				for(const svm_node *p=model->SV[k];p->index != -1;++p)
+					w[p->index] += model->sv_coef[i][k]*p->value;
+		}
+	free(start);
+}
+
+// alpha_i of the decision function of model between labels la and lb
+// for each instance i of its training set (0 if not an SV there), or
+// NULL if model has no such decision function
+static double *svc_pair_alpha(const svm_model *model, int l, int la, int lb)
+{
+	int i, a = -1, b = -1;
+	for(i=0;i<model->nr_class;i++)
+	{
+		if(model->label[i] == la) a = i;
+		if(model->label[i] == lb) b = i;
+	}
+	if(a < 0 || b < 0 || a == b)
+		return NULL;
+	if(a > b) swap(a,b);
+
+	int start_a = 0, start_b = 0;
+	for(i=0;i<a;i++) start_a += model->nSV[i];
+	for(i=0;i<b;i++) start_b += model->nSV[i];
+
+	// as in svm_train, coefficients of class a are in sv_coef[b-1] and
+	// those of class b are in sv_coef[a]
+	double *alpha = Malloc(double,l);
+	for(i=0;i<l;i++)
+		alpha[i] = 0;
+	for(i=start_a;i<start_a+model->nSV[a];i++)
+		if(model->sv_indices[i] >= 1 && model->sv_indices[i] <= l)
+			alpha[model->sv_indices[i]-1] = fabs(model->sv_coef[b-1][i]);
+	for(i=start_b;i<start_b+model->nSV[b];i++)
+		if(model->sv_indices[i] >= 1 && model->sv_indices[i] <= l)
+			alpha[model->sv_indices[i]-1] = fabs(model->sv_coef[a][i]);
+	return alpha;
+}
+
 //
 // Interface functions
 //
 svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 {
+	return svm_train_warm(prob,param,NULL,NULL);
+}
+
+svm_model *svm_train_warm(const svm_problem *prob, const svm_parameter *param,
+	const svm_model *init_model, svm_kernel_cache *cache)
+{
+	if(cache && (cache->param.kernel_type != param->kernel_type ||
+		     cache->param.degree != param->degree ||
+		     cache->param.gamma != param->gamma ||
+		     cache->param.coef0 != param->coef0 ||
+		     cache->param.single_precision != param->single_precision))
+		cache = NULL;	// created for another kernel or precision
+	if(init_model && (param->svm_type != C_SVC ||
+			  init_model->param.svm_type != C_SVC ||
+			  init_model->sv_indices == NULL))
+		init_model = NULL;
+
 	svm_model *model = Malloc(svm_model,1);
 	model->param = *param;
 	model->free_sv = 0;	// XXX
+	model->w = NULL;
+	model->w_dim = 0;
 
 	if(param->svm_type == ONE_CLASS ||
 	   param->svm_type == EPSILON_SVR ||
@@ -2114,7 +3082,7 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 			model->probA[0] = svm_svr_probability(prob,param);
 		}
 
-		decision_function f = svm_train_one(prob,param,0,0);
+		decision_function f = svm_train_one(prob,param,0,0,NULL,cache);
 		model->rho = Malloc(double,1);
 		model->rho[0] = f.rho;
 
@@ -2212,9 +3180,22 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 				}
 
 				if(param->probability)
-					svm_binary_svc_probability(&sub_prob,param,weighted_C[i],weighted_C[j],probA[p],probB[p]);
+					svm_binary_svc_probability(&sub_prob,param,weighted_C[i],weighted_C[j],probA[p],probB[p],cache);
 
-				f[p] = svm_train_one(&sub_prob,param,weighted_C[i],weighted_C[j]);
+				double *init_alpha = NULL;
+				double *pair_alpha = init_model? svc_pair_alpha(init_model,prob->l,label[i],label[j]) : NULL;
+				if(pair_alpha)
+				{
+					init_alpha = Malloc(double,sub_prob.l);
+					for(k=0;k<ci;k++)
+						init_alpha[k] = pair_alpha[perm[si+k]];
+					for(k=0;k<cj;k++)
+						init_alpha[ci+k] = pair_alpha[perm[sj+k]];
+					free(pair_alpha);
+				}
+
+				f[p] = svm_train_one(&sub_prob,param,weighted_C[i],weighted_C[j],init_alpha,cache);
+				free(init_alpha);
 				for(k=0;k<ci;k++)
 					if(!nonzero[si+k] && fabs(f[p].alpha[k]) > 0)
 						nonzero[si+k] = true;
@@ -2332,16 +3313,88 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 		free(nz_count);
 		free(nz_start);
 	}
+	svm_collapse_linear(model);
 	return model;
 }
 
-// Stratified cross validation
-void svm_cross_validation(const svm_problem *prob, const svm_parameter *param, int nr_fold, double *target)
+svm_kernel_cache *svm_create_kernel_cache(const svm_problem *prob, const svm_parameter *param)
+{
+	int i, l = prob->l;
+	svm_kernel_cache *cache = new svm_kernel_cache;
+	cache->l = l;
+	cache->param = *param;
+	cache->param.nr_weight = 0;
+	cache->param.weight_label = NULL;
+	cache->param.weight = NULL;
+	cache->kernel = new Row_Kernel(*prob,*param);
+
+	cache->sorted = Malloc(svm_kernel_cache::node_index,l);
+	for(i=0;i<l;i++)
+	{
+		cache->sorted[i].x = prob->x[i];
+		cache->sorted[i].i = i;
+	}
+	qsort(cache->sorted,l,sizeof(svm_kernel_cache::node_index),compare_node_index);
+
+	long int size = (long int)(param->cache_size*(1<<20))/sizeof(Qfloat);
+	cache->nr_slot = (int)max(min(size/max(l,1),(long int)l),1L);
+	cache->nr_used = 0;
+	cache->arena = Malloc(Qfloat,(size_t)cache->nr_slot*l);
+	cache->slot_of = Malloc(int,l);
+	for(i=0;i<l;i++)
+		cache->slot_of[i] = -1;
+	cache->row_of = Malloc(int,cache->nr_slot);
+	cache->prev = Malloc(int,cache->nr_slot+1);
+	cache->next = Malloc(int,cache->nr_slot+1);
+	cache->prev[cache->nr_slot] = cache->next[cache->nr_slot] = cache->nr_slot;
+	cache->pin = Malloc(int,cache->nr_slot);
+	cache->ready = Malloc(char,cache->nr_slot);
+	for(i=0;i<cache->nr_slot;i++)
+	{
+		cache->pin[i] = 0;
+		cache->ready[i] = 0;
+	}
+	cache->nr_hit = cache->nr_miss = 0;
+#ifdef _OPENMP
+	omp_init_lock(&cache->lock);
+	cache->fill = Malloc(omp_lock_t,cache->nr_slot);
+	for(i=0;i<cache->nr_slot;i++)
+		omp_init_lock(&cache->fill[i]);
+#endif
+	return cache;
+}
+
+void svm_destroy_kernel_cache(svm_kernel_cache *cache)
+{
+	if(cache == NULL)
+		return;
+	info("shared cache hits = %ld, misses = %ld\n",cache->nr_hit,cache->nr_miss);
+#ifdef _OPENMP
+	omp_destroy_lock(&cache->lock);
+	for(int i=0;i<cache->nr_slot;i++)
+		omp_destroy_lock(&cache->fill[i]);
+	free(cache->fill);
+#endif
+	delete cache->kernel;
+	free(cache->sorted);
+	free(cache->arena);
+	free(cache->slot_of);
+	free(cache->row_of);
+	free(cache->prev);
+	free(cache->next);
+	free(cache->pin);
+	free(cache->ready);
+	delete cache;
+}
+
+// Stratified split for cross validation: fold i consists of
+// perm[fold_start[i]],...,perm[fold_start[i+1]-1]; returns fold_start
+static int *svm_cross_validation_split(const svm_problem *prob, const svm_parameter *param, int *nr_fold_ret, int *perm)
 {
 	int i;
 	int *fold_start;
 	int l = prob->l;
-	int *perm = Malloc(int,l);
+	int nr_fold = *nr_fold_ret;
 	int nr_class;
 	if (nr_fold > l)
 	{
@@ -2412,42 +3465,89 @@ void svm_cross_validation(const svm_problem *prob, const svm_parameter *param, i
 			fold_start[i]=i*l/nr_fold;
 	}
 
+	*nr_fold_ret = nr_fold;
+	return fold_start;
+}
+
+// training set of the fold perm[begin,end)
+static void svm_cross_validation_subprob(const svm_problem *prob, const int *perm, int begin, int end, svm_problem *subprob)
+{
+	int j,k;
+	int l = prob->l;
+	subprob->l = l-(end-begin);
+	subprob->x = Malloc(struct svm_node*,subprob->l);
+	subprob->y = Malloc(double,subprob->l);
+		
+	k=0;
+	for(j=0;j<begin;j++)
+	{
+		subprob->x[k] = prob->x[perm[j]];
+		subprob->y[k] = prob->y[perm[j]];
+		++k;
+	}
+	for(j=end;j<l;j++)
+	{
+		subprob->x[k] = prob->x[perm[j]];
+		subprob->y[k] = prob->y[perm[j]];
+		++k;
+	}
+}
+
+static void svm_cross_validation_predict(const svm_problem *prob, const svm_parameter *param,
+	const svm_model *submodel, const int *perm, int begin, int end, double *target)
+{
+	int j;
+	if(param->probability && 
+	   (param->svm_type == C_SVC || param->svm_type == NU_SVC))
+	{
+		double *prob_estimates=Malloc(double,svm_get_nr_class(submodel));
+		for(j=begin;j<end;j++)
+			target[perm[j]] = svm_predict_probability(submodel,prob->x[perm[j]],prob_estimates);
+		free(prob_estimates);
+	}
+	else
+		for(j=begin;j<end;j++)
+			target[perm[j]] = svm_predict(submodel,prob->x[perm[j]]);
+}
+
+// Folds are trained by up to nr_thread workers, each with an equal
+// share of cache_size. Probability estimates draw from rand(), so
+// for them folds stay sequential to keep results reproducible.
+static int svm_cross_validation_workers(const svm_parameter *param, int nr_fold)
+{
+	int nr_worker = 1;
+#ifdef _OPENMP
+	if(!param->probability)
+	{
+		nr_worker = (param->nr_thread > 0)? param->nr_thread : omp_get_max_threads();
+		nr_worker = max(min(nr_worker,nr_fold),1);
+	}
+#endif
+	return nr_worker;
+}
+
+// Stratified cross validation
+void svm_cross_validation(const svm_problem *prob, const svm_parameter *param, int nr_fold, double *target)
+{
+	int i;
+	int l = prob->l;
+	int *perm = Malloc(int,l);
+	int *fold_start = svm_cross_validation_split(prob,param,&nr_fold,perm);
+
+	svm_parameter subparam = *param;
+	int nr_worker = svm_cross_validation_workers(param,nr_fold);
+	subparam.cache_size = param->cache_size/nr_worker;
+#ifdef _OPENMP
+#pragma omp parallel for private(i) schedule(dynamic) num_threads(nr_worker) if(nr_worker > 1)
+#endif
 	for(i=0;i<nr_fold;i++)
 	{
 		int begin = fold_start[i];
 		int end = fold_start[i+1];
-		int j,k;
 		struct svm_problem subprob;
-
-		subprob.l = l-(end-begin);
-		subprob.x = Malloc(struct svm_node*,subprob.l);
-		subprob.y = Malloc(double,subprob.l);
-			
-		k=0;
-		for(j=0;j<begin;j++)
-		{
-			subprob.x[k] = prob->x[perm[j]];
-			subprob.y[k] = prob->y[perm[j]];
-			++k;
-		}
-		for(j=end;j<l;j++)
-		{
-			subprob.x[k] = prob->x[perm[j]];
-			subprob.y[k] = prob->y[perm[j]];
-			++k;
-		}
-		struct svm_model *submodel = svm_train(&subprob,param);
-		if(param->probability && 
-		   (param->svm_type == C_SVC || param->svm_type == NU_SVC))
-		{
-			double *prob_estimates=Malloc(double,svm_get_nr_class(submodel));
-			for(j=begin;j<end;j++)
-				target[perm[j]] = svm_predict_probability(submodel,prob->x[perm[j]],prob_estimates);
-			free(prob_estimates);
-		}
-		else
-			for(j=begin;j<end;j++)
-				target[perm[j]] = svm_predict(submodel,prob->x[perm[j]]);
+		svm_cross_validation_subprob(prob,perm,begin,end,&subprob);
+		struct svm_model *submodel = svm_train(&subprob,&subparam);
+		svm_cross_validation_predict(prob,param,submodel,perm,begin,end,target);
 		svm_free_and_destroy_model(&submodel);
 		free(subprob.x);
 		free(subprob.y);
@@ -2456,27 +3556,505 @@ void svm_cross_validation(const svm_problem *prob, const svm_parameter *param, i
 	free(perm);
 }
 
-
-int svm_get_svm_type(const svm_model *model)
+// Cross validation for gamma[0],...,gamma[nr_gamma-1] and C[0],...,C[nr_C-1]
+// on one split; target[(g*nr_C+c)*l+i] is the prediction of instance i for
+// gamma[g] and C[c]. Every pair of a gamma and a fold is a job that keeps a
+// kernel cache for all values of C and warm-starts from the model of the
+// previous value; half of the share of cache_size of a worker goes to it.
+void svm_cross_validation_grid(const svm_problem *prob, const svm_parameter *param, int nr_fold,
+	int nr_gamma, const double *gamma, int nr_C, const double *C, double *target)
 {
-	return model->param.svm_type;
+	int k;
+	int l = prob->l;
+	int *perm = Malloc(int,l);
+	int *fold_start = svm_cross_validation_split(prob,param,&nr_fold,perm);
+	int nr_job = nr_gamma*nr_fold;
+
+	svm_parameter subparam = *param;
+	int nr_worker = svm_cross_validation_workers(param,nr_job);
+	subparam.cache_size = param->cache_size/nr_worker/2;
+#ifdef _OPENMP
+#pragma omp parallel for private(k) schedule(dynamic) num_threads(nr_worker) if(nr_worker > 1)
+#endif
+	for(k=0;k<nr_job;k++)
+	{
+		int g = k/nr_fold;
+		int begin = fold_start[k%nr_fold];
+		int end = fold_start[k%nr_fold+1];
+		struct svm_problem subprob;
+		svm_parameter foldparam = subparam;
+		foldparam.gamma = gamma[g];
+		svm_cross_validation_subprob(prob,perm,begin,end,&subprob);
+		svm_kernel_cache *cache = svm_create_kernel_cache(&subprob,&foldparam);
+		struct svm_model *prev = NULL;
+		for(int c=0;c<nr_C;c++)
+		{
+			foldparam.C = C[c];
+			struct svm_model *submodel = svm_train_warm(&subprob,&foldparam,prev,cache);
+			svm_cross_validation_predict(prob,param,submodel,perm,begin,end,&target[((size_t)g*nr_C+c)*l]);
+			svm_free_and_destroy_model(&prev);
+			prev = submodel;
+		}
+		svm_free_and_destroy_model(&prev);
+		svm_destroy_kernel_cache(cache);
+		free(subprob.x);
+		free(subprob.y);
+	}
+	free(fold_start);
+	free(perm);
 }
 
-int svm_get_nr_class(const svm_model *model)
+// Cross validation for C[0],...,C[nr_C-1] on one split
+void svm_cross_validation_path(const svm_problem *prob, const svm_parameter *param, int nr_fold,
+	int nr_C, const double *C, double *target)
 {
-	return model->nr_class;
+	svm_cross_validation_grid(prob,param,nr_fold,1,&param->gamma,nr_C,C,target);
 }
 
-void svm_get_labels(const svm_model *model, int* label)
-{
-	if (model->label != NULL)
-		for(int i=0;i<model->nr_class;i++)
-			label[i] = model->label[i];
-}
+static double svc_predict_probability_dec(const svm_model *model, const double *dec_values, double *prob_estimates);
 
-void svm_get_sv_indices(const svm_model *model, int* indices)
+// Out-of-fold decision values of the pairs of classes label[0,nr_class)
+// for instances perm[begin,end), given the model of the other folds.
+// A class may be missing from the other folds: as in
+// svm_binary_svc_probability, a pair then gets +1 if only its first
+// class was trained, -1 if only its second, and 0 if neither.
+static void svm_cross_validation_dec_values(const svm_problem *prob, const svm_model *submodel,
+	int nr_class, const int *label, const int *perm, int begin, int end, double *dec_values)
 {
-	if (model->sv_indices != NULL)
+	int i,j,k;
+	int nr_pair = nr_class*(nr_class-1)/2;
+	int sub_nr_class = submodel->nr_class;
+	int *sub_index = Malloc(int,nr_class);
+	double *sub_dec = Malloc(double,sub_nr_class*(sub_nr_class-1)/2);
+
+	for(i=0;i<nr_class;i++)
+	{
+		sub_index[i] = -1;
+		for(j=0;j<sub_nr_class;j++)
+			if(submodel->label[j] == label[i])
+				sub_index[i] = j;
+	}
+	for(k=begin;k<end;k++)
+	{
+		double *dec = &dec_values[(size_t)perm[k]*nr_pair];
+		svm_predict_values(submodel,prob->x[perm[k]],sub_dec);
+		int p = 0;
+		for(i=0;i<nr_class;i++)
+			for(j=i+1;j<nr_class;j++)
+			{
+				int si = sub_index[i], sj = sub_index[j];
+				if(si >= 0 && sj >= 0)
+				{
+					int a = min(si,sj), b = max(si,sj);
+					double v = sub_dec[a*sub_nr_class-a*(a+1)/2+b-a-1];
+					dec[p] = (si < sj)? v : -v;
+				}
+				else if(si >= 0)
+					dec[p] = 1;
+				else if(sj >= 0)
+					dec[p] = -1;
+				else
+					dec[p] = 0;
+				p++;
+			}
+	}
+	free(sub_dec);
+	free(sub_index);
+}
+
+// Cross validation and training in one. Folds are trained without
+// probability estimates; if param->probability is 1, the probability
+// information of the model of the whole problem is fitted to their
+// out-of-fold decision values (residuals for SVR) instead of to the
+// 5 extra trainings per pair of classes done by svm_train.
+svm_model *svm_train_cross_validation(const svm_problem *prob, const svm_parameter *param, int nr_fold, double *target)
+{
+	int i;
+	int l = prob->l;
+	int *perm = Malloc(int,l);
+	int *fold_start = svm_cross_validation_split(prob,param,&nr_fold,perm);
+	bool svc_probability = param->probability &&
+		(param->svm_type == C_SVC || param->svm_type == NU_SVC);
+
+	int nr_class = 0, nr_pair = 0;
+	int *label = NULL;
+	double *dec_values = NULL;
+	if(svc_probability)
+	{
+		int *start = NULL;
+		int *count = NULL;
+		int *class_perm = Malloc(int,l);
+		svm_group_classes(prob,&nr_class,&label,&start,&count,class_perm);
+		free(start);
+		free(count);
+		free(class_perm);
+		nr_pair = nr_class*(nr_class-1)/2;
+		dec_values = Malloc(double,(size_t)l*nr_pair);
+	}
+
+	svm_parameter subparam = *param;
+	subparam.probability = 0;
+	int nr_worker = svm_cross_validation_workers(&subparam,nr_fold);
+	subparam.cache_size = param->cache_size/nr_worker;
+#ifdef _OPENMP
+#pragma omp parallel for private(i) schedule(dynamic) num_threads(nr_worker) if(nr_worker > 1)
+#endif
+	for(i=0;i<nr_fold;i++)
+	{
+		int begin = fold_start[i];
+		int end = fold_start[i+1];
+		struct svm_problem subprob;
+		svm_cross_validation_subprob(prob,perm,begin,end,&subprob);
+		struct svm_model *submodel = svm_train(&subprob,&subparam);
+		if(svc_probability)
+			svm_cross_validation_dec_values(prob,submodel,nr_class,label,perm,begin,end,dec_values);
+		else
+			svm_cross_validation_predict(prob,&subparam,submodel,perm,begin,end,target);
+		svm_free_and_destroy_model(&submodel);
+		free(subprob.x);
+		free(subprob.y);
+	}
+	free(fold_start);
+	free(perm);
+
+	subparam.cache_size = param->cache_size;
+	svm_model *model = svm_train(prob,&subparam);
+	model->param.probability = param->probability;
+	if(svc_probability)
+	{
+		// model->label is label, both from svm_group_classes
+		double *dec = Malloc(double,l);
+		double *y = Malloc(double,l);
+		int p = 0;
+		model->probA = Malloc(double,nr_pair);
+		model->probB = Malloc(double,nr_pair);
+		for(int c=0;c<nr_class;c++)
+			for(int d=c+1;d<nr_class;d++)
+			{
+				int n = 0;
+				for(i=0;i<l;i++)
+				{
+					int yi = (int)prob->y[i];
+					if(yi == label[c] || yi == label[d])
+					{
+						dec[n] = dec_values[(size_t)i*nr_pair+p];
+						y[n] = (yi == label[c])? +1 : -1;
+						++n;
+					}
+				}
+				sigmoid_train(n,dec,y,model->probA[p],model->probB[p]);
+				++p;
+			}
+		free(dec);
+		free(y);
+
+		double *prob_estimates = Malloc(double,nr_class);
+		for(i=0;i<l;i++)
+			target[i] = svc_predict_probability_dec(model,&dec_values[(size_t)i*nr_pair],prob_estimates);
+		free(prob_estimates);
+		free(dec_values);
+		free(label);
+	}
+	else if(param->probability &&
+		(param->svm_type == EPSILON_SVR || param->svm_type == NU_SVR))
+	{
+		model->probA = Malloc(double,1);
+		model->probA[0] = svm_svr_laplace_scale(prob,target);
+	}
+	return model;
+}
+
+// Biased SVM for PU learning (Liu et al., ICDM 2003): a C-SVC of the
+// positive (+1) against the unlabeled (-1) instances with costs Cp and
+// Cn, chosen by the out-of-fold score recall^2/Pr[f(x)=1] of Lee and
+// Liu (ICML 2003). One kernel cache of the whole problem is shared by
+// all folds, all (Cp,Cn) and the final model; folds run in parallel and
+// compute the rows they miss concurrently, as the cache is only locked
+// to look up or reserve a row. In each fold the grid is walked row by
+// row of Cn, alternating the direction of Cp, and every point
+// warm-starts from the previous one.
+svm_model *svm_train_pu_bsvm(const svm_problem *prob, const svm_parameter *param, int nr_fold,
+	int nr_Cp, const double *Cp, int nr_Cn, const double *Cn, double *score, int *best)
+{
+	int i;
+	int l = prob->l;
+	int nr_point = nr_Cp*nr_Cn;
+	int *perm = Malloc(int,l);
+	int *fold_start = svm_cross_validation_split(prob,param,&nr_fold,perm);
+	// per fold and point: validation positives predicted +1, and all predicted +1
+	int *nr_tp = Malloc(int,(size_t)nr_fold*nr_point);
+	int *nr_pp = Malloc(int,(size_t)nr_fold*nr_point);
+	int weight_label[2] = {+1,-1};
+
+	svm_parameter subparam = *param;
+	subparam.svm_type = C_SVC;
+	subparam.probability = 0;
+	subparam.C = 1;
+	subparam.nr_weight = 2;
+	subparam.weight_label = weight_label;
+	int nr_worker = svm_cross_validation_workers(&subparam,nr_fold);
+	subparam.cache_size = param->cache_size/2;
+	svm_kernel_cache *cache = svm_create_kernel_cache(prob,&subparam);
+	subparam.cache_size = param->cache_size/nr_worker/2;
+#ifdef _OPENMP
+#pragma omp parallel for private(i) schedule(dynamic) num_threads(nr_worker) if(nr_worker > 1)
+#endif
+	for(i=0;i<nr_fold;i++)
+	{
+		int begin = fold_start[i];
+		int end = fold_start[i+1];
+		int j;
+		double weight[2];
+		struct svm_problem subprob;
+		svm_parameter foldparam = subparam;
+		svm_node **x = Malloc(svm_node *,end-begin);
+		double *pred = Malloc(double,end-begin);
+		foldparam.weight = weight;
+		svm_cross_validation_subprob(prob,perm,begin,end,&subprob);
+		for(j=begin;j<end;j++)
+			x[j-begin] = prob->x[perm[j]];
+
+		struct svm_model *prev = NULL;
+		for(int g=0;g<nr_point;g++)
+		{
+			int n = g/nr_Cp;
+			int c = (n%2 == 0)? g%nr_Cp : nr_Cp-1-g%nr_Cp;
+			int tp = 0, pp = 0;
+			weight[0] = Cp[c];
+			weight[1] = Cn[n];
+			struct svm_model *submodel = svm_train_warm(&subprob,&foldparam,prev,cache);
+			svm_predict_batch(submodel,end-begin,x,pred);
+			for(j=begin;j<end;j++)
+				if(pred[j-begin] > 0)
+				{
+					++pp;
+					if(prob->y[perm[j]] > 0)
+						++tp;
+				}
+			nr_tp[(size_t)i*nr_point+n*nr_Cp+c] = tp;
+			nr_pp[(size_t)i*nr_point+n*nr_Cp+c] = pp;
+			svm_free_and_destroy_model(&prev);
+			prev = submodel;
+		}
+		svm_free_and_destroy_model(&prev);
+		free(x);
+		free(pred);
+		free(subprob.x);
+		free(subprob.y);
+	}
+	free(fold_start);
+	free(perm);
+
+	int nr_positive = 0;
+	for(i=0;i<l;i++)
+		if(prob->y[i] > 0)
+			++nr_positive;
+	int best_point = 0;
+	double best_score = -1;
+	for(int g=0;g<nr_point;g++)
+	{
+		double tp = 0, pp = 0;
+		for(i=0;i<nr_fold;i++)
+		{
+			tp += nr_tp[(size_t)i*nr_point+g];
+			pp += nr_pp[(size_t)i*nr_point+g];
+		}
+		// recall^2/Pr[f(x)=1] = (tp/nr_positive)^2/(pp/l)
+		double s = (pp > 0)? tp*tp*l/((double)nr_positive*nr_positive*pp) : 0;
+		if(score)
+			score[g] = s;
+		if(s > best_score)
+		{
+			best_score = s;
+			best_point = g;
+		}
+	}
+	free(nr_tp);
+	free(nr_pp);
+	if(best)
+		*best = best_point;
+
+	double weight[2] = {Cp[best_point%nr_Cp],Cn[best_point/nr_Cp]};
+	subparam.cache_size = param->cache_size/2;
+	subparam.weight = weight;
+	svm_model *model = svm_train_warm(prob,&subparam,NULL,cache);
+	svm_destroy_kernel_cache(cache);
+	// the weights are local; the costs are given by *best
+	model->param.nr_weight = 0;
+	model->param.weight_label = NULL;
+	model->param.weight = NULL;
+	return model;
+}
+
+// Iterative SVM for PU learning (Liu et al., ICDM 2003): the positives
+// are trained against the reliable negatives RN, the remaining unlabeled
+// instances Q predicted negative move into RN, and so on until none
+// moves. Instances are only appended to the training problem, so each
+// round warm-starts from the alphas of the previous one (the indices of
+// its support vectors are unchanged) and all rounds share one kernel
+// cache of prob. Only the shrinking Q is rescored, by svm_predict_batch.
+svm_model *svm_train_pu_iterative(const svm_problem *prob, const svm_parameter *param,
+	double *label, int *nr_iter)
+{
+	int i;
+	int l = prob->l;
+	int nr_positive = 0, nr_rn = 0, nr_q = 0;
+	svm_node **x = Malloc(svm_node *,l);	// positives, then RN in order of arrival
+	double *y = Malloc(double,l);
+	int *index = Malloc(int,l);		// of x in prob
+	int *q = Malloc(int,l);			// indices of Q in prob
+	svm_node **qx = Malloc(svm_node *,l);
+	double *pred = Malloc(double,l);
+	char *in_rn = Malloc(char,l);
+
+	svm_parameter subparam = *param;
+	subparam.svm_type = C_SVC;
+	subparam.probability = 0;
+	subparam.cache_size = param->cache_size/2;
+	svm_kernel_cache *cache = svm_create_kernel_cache(prob,&subparam);
+	svm_model *seed_model = NULL;
+
+	for(i=0;i<l;i++)
+	{
+		in_rn[i] = (prob->y[i] < 0);
+		if(prob->y[i] > 0)
+		{
+			x[nr_positive] = prob->x[i];
+			index[nr_positive] = i;
+			y[nr_positive++] = +1;
+		}
+		else if(prob->y[i] < 0)
+			++nr_rn;
+		else
+			q[nr_q++] = i;
+	}
+
+	if(nr_rn == 0)
+	{
+		// no reliable negatives given: take those of Q predicted negative
+		// by the positives against all of Q
+		for(i=0;i<l;i++)
+			pred[i] = (prob->y[i] > 0)? +1 : -1;
+		svm_problem first = {l,pred,prob->x};
+		seed_model = svm_train_warm(&first,&subparam,NULL,cache);
+		for(i=0;i<nr_q;i++)
+			qx[i] = prob->x[q[i]];
+		svm_predict_batch(seed_model,nr_q,qx,pred);
+		for(i=0;i<nr_q;i++)
+			if(pred[i] < 0)
+				in_rn[q[i]] = 1;
+		int k = 0;
+		for(i=0;i<nr_q;i++)
+			if(!in_rn[q[i]])
+				q[k++] = q[i];
+		nr_q = k;
+		// if all of Q moved into RN, the first round would train the
+		// positives against all of Q again: the seed model is the result
+		if(nr_q > 0)
+			svm_free_and_destroy_model(&seed_model);
+	}
+	int nr_train = nr_positive;
+	for(i=0;i<l;i++)
+		if(in_rn[i])
+		{
+			x[nr_train] = prob->x[i];
+			index[nr_train] = i;
+			y[nr_train++] = -1;
+		}
+
+	svm_model *first_model = seed_model;
+	svm_model *model = seed_model;
+	int iter = (seed_model != NULL);
+	while(seed_model == NULL)
+	{
+		svm_problem subprob = {nr_train,y,x};
+		svm_model *next = svm_train_warm(&subprob,&subparam,model,cache);
+		++iter;
+		if(model != first_model)
+			svm_free_and_destroy_model(&model);
+		model = next;
+		if(first_model == NULL)
+			first_model = model;
+
+		for(i=0;i<nr_q;i++)
+			qx[i] = prob->x[q[i]];
+		svm_predict_batch(model,nr_q,qx,pred);
+		int k = 0;
+		for(i=0;i<nr_q;i++)
+			if(pred[i] < 0)
+			{
+				in_rn[q[i]] = 1;
+				x[nr_train] = prob->x[q[i]];
+				index[nr_train] = q[i];
+				y[nr_train++] = -1;
+			}
+			else
+				q[k++] = q[i];
+		if(k == nr_q)
+			break;
+		nr_q = k;
+	}
+	info("\n%d rounds, %d reliable negatives\n",iter,nr_train-nr_positive);
+
+	// the last model is kept unless it misclassifies more than 5% of
+	// the positives, as it may then have drifted into the positive class
+	if(model != first_model)
+	{
+		svm_predict_batch(model,nr_positive,x,pred);
+		int nr_lost = 0;
+		for(i=0;i<nr_positive;i++)
+			if(pred[i] < 0)
+				++nr_lost;
+		if(nr_lost > 0.05*nr_positive)
+		{
+			info("%d positives misclassified; the first model is returned\n",nr_lost);
+			svm_free_and_destroy_model(&model);
+			model = first_model;
+		}
+		else
+			svm_free_and_destroy_model(&first_model);
+	}
+	svm_destroy_kernel_cache(cache);
+
+	if(label)
+		for(i=0;i<l;i++)
+			label[i] = (prob->y[i] > 0)? +1 : in_rn[i]? -1 : 0;
+	if(nr_iter)
+		*nr_iter = iter;
+	if(model->sv_indices && model != seed_model)	// the seed model is trained on prob
+		for(i=0;i<model->l;i++)
+			model->sv_indices[i] = index[model->sv_indices[i]-1]+1;
+	free(x);
+	free(y);
+	free(index);
+	free(q);
+	free(qx);
+	free(pred);
+	free(in_rn);
+	return model;
+}
+
+
+int svm_get_svm_type(const svm_model *model)
+{
+	return model->param.svm_type;
+}
+
+int svm_get_nr_class(const svm_model *model)
+{
+	return model->nr_class;
+}
+
+void svm_get_labels(const svm_model *model, int* label)
+{
+	if (model->label != NULL)
+		for(int i=0;i<model->nr_class;i++)
+			label[i] = model->label[i];
+}
+
+void svm_get_sv_indices(const svm_model *model, int* indices)
+{
+	if (model->sv_indices != NULL)
 		for(int i=0;i<model->l;i++)
 			indices[i] = model->sv_indices[i];
 }
@@ -2498,10 +4076,109 @@ double svm_get_svr_probability(const svm_model *model)
 	}
 }
 
+// predicted label of a classifier given its decision values;
+// vote is scratch of length nr_class
+static double svc_vote(const svm_model *model, const double *dec_values, int *vote)
+{
+	int i;
+	int nr_class = model->nr_class;
+
+	for(i=0;i<nr_class;i++)
+		vote[i] = 0;
+
+	int p=0;
+	for(i=0;i<nr_class;i++)
+		for(int j=i+1;j<nr_class;j++)
+		{
+			if(dec_values[p] > 0)
+				++vote[i];
+			else
+				++vote[j];
+			p++;
+		}
+
+	int vote_max_idx = 0;
+	for(i=1;i<nr_class;i++)
+		if(vote[i] > vote[vote_max_idx])
+			vote_max_idx = i;
+
+	return model->label[vote_max_idx];
+}
+
+// decision values and predicted label of a classifier given
+// kvalue[i] = K(x,SV[i]); start and vote are scratch of length nr_class
+static double svc_predict_kvalue(const svm_model *model, const double *kvalue, int *start, int *vote, double *dec_values)
+{
+	int i;
+	int nr_class = model->nr_class;
+
+	start[0] = 0;
+	for(i=1;i<nr_class;i++)
+		start[i] = start[i-1]+model->nSV[i-1];
+
+	int p=0;
+	for(i=0;i<nr_class;i++)
+		for(int j=i+1;j<nr_class;j++)
+		{
+			double sum = 0;
+			int si = start[i];
+			int sj = start[j];
+			int ci = model->nSV[i];
+			int cj = model->nSV[j];
+			
+			int k;
+			double *coef1 = model->sv_coef[j-1];
+			double *coef2 = model->sv_coef[i];
+			for(k=0;k<ci;k++)
+				sum += coef1[si+k] * kvalue[si+k];
+			for(k=0;k<cj;k++)
+				sum += coef2[sj+k] * kvalue[sj+k];
+			sum -= model->rho[p];
+			dec_values[p] = sum;
+			p++;
+		}
+
+	return svc_vote(model,dec_values,vote);
+}
+
+// decision values and predicted label of a model collapsed by
+// svm_collapse_linear; features beyond w_dim have zero weight
+static double linear_predict_values(const svm_model *model, const svm_node *x, double *dec_values, int *vote)
+{
+	int svm_type = model->param.svm_type;
+	int nr_dec = model->nr_class*(model->nr_class-1)/2;
+	if(svm_type == ONE_CLASS || svm_type == EPSILON_SVR || svm_type == NU_SVR)
+		nr_dec = 1;
+
+	for(int p=0;p<nr_dec;p++)
+	{
+		const double *w = model->w[p];
+		double sum = 0;
+		for(const svm_node *px=x;px->index != -1;++px)
+			if(px->index < model->w_dim)
+				sum += px->value*w[px->index];
+		dec_values[p] = sum - model->rho[p];
+	}
+
+	if(svm_type == ONE_CLASS)
+		return (dec_values[0]>0)?1:-1;
+	else if(svm_type == EPSILON_SVR || svm_type == NU_SVR)
+		return dec_values[0];
+	else
+		return svc_vote(model,dec_values,vote);
+}
+
 double svm_predict_values(const svm_model *model, const svm_node *x, double* dec_values)
 {
 	int i;
-	if(model->param.svm_type == ONE_CLASS ||
+	if(model->w != NULL)
+	{
+		int *vote = Malloc(int,model->nr_class);
+		double pred_result = linear_predict_values(model,x,dec_values,vote);
+		free(vote);
+		return pred_result;
+	}
+	else if(model->param.svm_type == ONE_CLASS ||
 	   model->param.svm_type == EPSILON_SVR ||
 	   model->param.svm_type == NU_SVR)
 	{
@@ -2527,50 +4204,13 @@ double svm_predict_values(const svm_model *model, const svm_node *x, double* dec
 			kvalue[i] = Kernel::k_function(x,model->SV[i],model->param);
 
 		int *start = Malloc(int,nr_class);
-		start[0] = 0;
-		for(i=1;i<nr_class;i++)
-			start[i] = start[i-1]+model->nSV[i-1];
-
 		int *vote = Malloc(int,nr_class);
-		for(i=0;i<nr_class;i++)
-			vote[i] = 0;
-
-		int p=0;
-		for(i=0;i<nr_class;i++)
-			for(int j=i+1;j<nr_class;j++)
-			{
-				double sum = 0;
-				int si = start[i];
-				int sj = start[j];
-				int ci = model->nSV[i];
-				int cj = model->nSV[j];
-				
-				int k;
-				double *coef1 = model->sv_coef[j-1];
-				double *coef2 = model->sv_coef[i];
-				for(k=0;k<ci;k++)
-					sum += coef1[si+k] * kvalue[si+k];
-				for(k=0;k<cj;k++)
-					sum += coef2[sj+k] * kvalue[sj+k];
-				sum -= model->rho[p];
-				dec_values[p] = sum;
-
-				if(dec_values[p] > 0)
-					++vote[i];
-				else
-					++vote[j];
-				p++;
-			}
-
-		int vote_max_idx = 0;
-		for(i=1;i<nr_class;i++)
-			if(vote[i] > vote[vote_max_idx])
-				vote_max_idx = i;
+		double pred_result = svc_predict_kvalue(model,kvalue,start,vote,dec_values);
 
 		free(kvalue);
 		free(start);
 		free(vote);
-		return model->label[vote_max_idx];
+		return pred_result;
 	}
 }
 
@@ -2589,49 +4229,354 @@ double svm_predict(const svm_model *model, const svm_node *x)
 	return pred_result;
 }
 
+// probability estimates and predicted label of a classifier with
+// probability information given its decision values
+static double svc_predict_probability_dec(const svm_model *model, const double *dec_values, double *prob_estimates)
+{
+	int i;
+	int nr_class = model->nr_class;
+
+	double min_prob=1e-7;
+	double **pairwise_prob=Malloc(double *,nr_class);
+	for(i=0;i<nr_class;i++)
+		pairwise_prob[i]=Malloc(double,nr_class);
+	int k=0;
+	for(i=0;i<nr_class;i++)
+		for(int j=i+1;j<nr_class;j++)
+		{
+			pairwise_prob[i][j]=min(max(sigmoid_predict(dec_values[k],model->probA[k],model->probB[k]),min_prob),1-min_prob);
+			pairwise_prob[j][i]=1-pairwise_prob[i][j];
+			k++;
+		}
+	if (nr_class == 2)
+	{
+		prob_estimates[0] = pairwise_prob[0][1];
+		prob_estimates[1] = pairwise_prob[1][0];
+	}
+	else
+		multiclass_probability(nr_class,pairwise_prob,prob_estimates);
+
+	int prob_max_idx = 0;
+	for(i=1;i<nr_class;i++)
+		if(prob_estimates[i] > prob_estimates[prob_max_idx])
+			prob_max_idx = i;
+	for(i=0;i<nr_class;i++)
+		free(pairwise_prob[i]);
+	free(pairwise_prob);
+	return model->label[prob_max_idx];
+}
+
 double svm_predict_probability(
 	const svm_model *model, const svm_node *x, double *prob_estimates)
 {
 	if ((model->param.svm_type == C_SVC || model->param.svm_type == NU_SVC) &&
 	    model->probA!=NULL && model->probB!=NULL)
 	{
-		int i;
 		int nr_class = model->nr_class;
 		double *dec_values = Malloc(double, nr_class*(nr_class-1)/2);
 		svm_predict_values(model, x, dec_values);
+		double pred_result = svc_predict_probability_dec(model, dec_values, prob_estimates);
+		free(dec_values);
+		return pred_result;
+	}
+	else 
+		return svm_predict(model, x);
+}
 
-		double min_prob=1e-7;
-		double **pairwise_prob=Malloc(double *,nr_class);
-		for(i=0;i<nr_class;i++)
-			pairwise_prob[i]=Malloc(double,nr_class);
-		int k=0;
-		for(i=0;i<nr_class;i++)
-			for(int j=i+1;j<nr_class;j++)
+//
+// Batch prediction
+//
+// SV_Kernel computes K(x_s,SV_j) for a block of at most PREDICT_BLOCK
+// instances against all SVs in one pass over the SVs, so each SV is
+// read once per block rather than once per instance.
+//
+// If the SVs are dense enough (same rule as in Kernel) they are copied
+// into a dense matrix and the block of instances is transposed, so the
+// innermost loop runs across the instances of the block. That loop has
+// one accumulator per instance and vectorizes; the values are equal to
+// k_function up to rounding, as the features of an instance that no SV
+// has are added to the RBF distance last instead of in index order.
+// Otherwise each
+// instance is scattered into a dense vector and the SVs are gathered;
+// for RBF this uses |x|^2+|SV|^2-2x'SV and may differ from k_function
+// in the last bits.
+//
+#define PREDICT_BLOCK 16
+
+class SV_Kernel
+{
+public:
+	SV_Kernel(const svm_model *model);
+	~SV_Kernel();
+
+	// kvalue[s*l+j] = K(x[s],SV[j]) for s in [0,n), n <= PREDICT_BLOCK;
+	// scratch must have room for scratch_size() doubles
+	void compute(int n, const svm_node * const *x, double *kvalue, double *scratch) const;
+	int scratch_size() const { return dim*PREDICT_BLOCK; }
+private:
+	const svm_model *model;
+	int l;
+	bool use_k_function;	// precomputed kernel or negative indices
+	int dim;		// features [0,dim) of x take part in dot products
+	double *sv_dense;	// l x dim, NULL for the scatter/gather layout
+	double *sv_square;	// for RBF in the scatter/gather layout
+
+	double kernel_from_dot(double d, double x_square, int j) const
+	{
+		const svm_parameter& param = model->param;
+		switch(param.kernel_type)
+		{
+			case POLY:
+				return powi(param.gamma*d+param.coef0,param.degree);
+			case RBF:
+				return exp(-param.gamma*(x_square+sv_square[j]-2*d));
+			case SIGMOID:
+				return tanh(param.gamma*d+param.coef0);
+			default:
+				return d;
+		}
+	}
+};
+
+SV_Kernel::SV_Kernel(const svm_model *model_):model(model_),l(model_->l)
+{
+	int i;
+	double nnz = 0;
+	int max_index = -1;
+	sv_dense = NULL;
+	sv_square = NULL;
+	dim = 0;
+	use_k_function = true;
+	// a collapsed linear model does not need kernel values
+	if(model->param.kernel_type == PRECOMPUTED || model->w != NULL)
+		return;
+
+	for(i=0;i<l;i++)
+		for(const svm_node *p=model->SV[i];p->index != -1;++p)
+		{
+			if(p->index < 0)
+				return;
+			max_index = max(max_index,p->index);
+			++nnz;
+		}
+	use_k_function = false;
+	dim = max_index+1;
+
+	if(dim > 0 && (double)l*dim*sizeof(double) <= (nnz+l)*sizeof(svm_node))
+	{
+		sv_dense = Malloc(double,(size_t)l*dim);
+		for(i=0;i<l;i++)
+		{
+			double *row = &sv_dense[(size_t)i*dim];
+			for(int k=0;k<dim;k++)
+				row[k] = 0;
+			for(const svm_node *p=model->SV[i];p->index != -1;++p)
+				row[p->index] = p->value;
+		}
+	}
+	else if(model->param.kernel_type == RBF)
+	{
+		sv_square = Malloc(double,l);
+		for(i=0;i<l;i++)
+		{
+			double sum = 0;
+			for(const svm_node *p=model->SV[i];p->index != -1;++p)
+				sum += p->value*p->value;
+			sv_square[i] = sum;
+		}
+	}
+}
+
+SV_Kernel::~SV_Kernel()
+{
+	free(sv_dense);
+	free(sv_square);
+}
+
+void SV_Kernel::compute(int n, const svm_node * const *x, double *kvalue, double *scratch) const
+{
+	int s, j, k;
+	const svm_parameter& param = model->param;
+
+	if(use_k_function)
+	{
+		for(s=0;s<n;s++)
+			for(j=0;j<l;j++)
+				kvalue[s*l+j] = Kernel::k_function(x[s],model->SV[j],param);
+		return;
+	}
+
+	if(sv_dense)
+	{
+		// xt[k*PREDICT_BLOCK+s] is feature k of x[s]; features outside
+		// [0,dim), including negative indices, only matter for the RBF
+		// distance
+		double *xt = scratch;
+		double x_tail[PREDICT_BLOCK];
+		for(k=0;k<dim*PREDICT_BLOCK;k++)
+			xt[k] = 0;
+		for(s=0;s<n;s++)
+		{
+			x_tail[s] = 0;
+			for(const svm_node *p=x[s];p->index != -1;++p)
+				if(p->index >= 0 && p->index < dim)
+					xt[p->index*PREDICT_BLOCK+s] = p->value;
+				else
+					x_tail[s] += p->value*p->value;
+		}
+
+		for(j=0;j<l;j++)
+		{
+			const double *sv = &sv_dense[(size_t)j*dim];
+			double acc[PREDICT_BLOCK];
+			for(s=0;s<PREDICT_BLOCK;s++)
+				acc[s] = 0;
+			if(param.kernel_type == RBF)
+			{
+				for(k=0;k<dim;k++)
+				{
+					const double *xk = &xt[k*PREDICT_BLOCK];
+					double v = sv[k];
+					for(s=0;s<PREDICT_BLOCK;s++)
+					{
+						double d = xk[s]-v;
+						acc[s] += d*d;
+					}
+				}
+				for(s=0;s<n;s++)
+					kvalue[s*l+j] = exp(-param.gamma*(acc[s]+x_tail[s]));
+			}
+			else
 			{
-				pairwise_prob[i][j]=min(max(sigmoid_predict(dec_values[k],model->probA[k],model->probB[k]),min_prob),1-min_prob);
-				pairwise_prob[j][i]=1-pairwise_prob[i][j];
-				k++;
+				for(k=0;k<dim;k++)
+				{
+					const double *xk = &xt[k*PREDICT_BLOCK];
+					double v = sv[k];
+					for(s=0;s<PREDICT_BLOCK;s++)
+						acc[s] += xk[s]*v;
+				}
+				for(s=0;s<n;s++)
+					kvalue[s*l+j] = kernel_from_dot(acc[s],0,j);
 			}
-		if (nr_class == 2)
+		}
+	}
+	else
+	{
+		double *xd = scratch;
+		for(k=0;k<dim;k++)
+			xd[k] = 0;
+		for(s=0;s<n;s++)
 		{
-			prob_estimates[0] = pairwise_prob[0][1];
-			prob_estimates[1] = pairwise_prob[1][0];
+			double x_square = 0;
+			for(const svm_node *p=x[s];p->index != -1;++p)
+			{
+				if(p->index >= 0 && p->index < dim)
+					xd[p->index] = p->value;
+				x_square += p->value*p->value;
+			}
+
+			double *kv = &kvalue[s*l];
+			for(j=0;j<l;j++)
+			{
+				double sum = 0;
+				for(const svm_node *p=model->SV[j];p->index != -1;++p)
+					sum += p->value*xd[p->index];
+				kv[j] = kernel_from_dot(sum,x_square,j);
+			}
+
+			for(const svm_node *p=x[s];p->index != -1;++p)
+				if(p->index >= 0 && p->index < dim)
+					xd[p->index] = 0;
 		}
-		else
-			multiclass_probability(nr_class,pairwise_prob,prob_estimates);
+	}
+}
 
-		int prob_max_idx = 0;
-		for(i=1;i<nr_class;i++)
-			if(prob_estimates[i] > prob_estimates[prob_max_idx])
-				prob_max_idx = i;
-		for(i=0;i<nr_class;i++)
-			free(pairwise_prob[i]);
-		free(dec_values);
-		free(pairwise_prob);
-		return model->label[prob_max_idx];
+// fills whichever of dec_values, prob_estimates and predictions is not NULL
+static void svm_predict_batch_internal(const svm_model *model, int n, svm_node * const *x,
+	double *dec_values, double *prob_estimates, double *predictions)
+{
+	int b;
+	int l = model->l;
+	int nr_class = model->nr_class;
+	int svm_type = model->param.svm_type;
+	bool is_svc = (svm_type == C_SVC || svm_type == NU_SVC);
+	int nr_dec = is_svc? nr_class*(nr_class-1)/2 : 1;
+	int nr_block = (n+PREDICT_BLOCK-1)/PREDICT_BLOCK;
+	bool collapsed = (model->w != NULL);
+	if(prob_estimates && !(is_svc && model->probA != NULL && model->probB != NULL))
+		prob_estimates = NULL;
+
+	SV_Kernel K(model);
+#ifdef _OPENMP
+	int nr_thread = (model->param.nr_thread > 0)? model->param.nr_thread : omp_get_max_threads();
+#pragma omp parallel num_threads(nr_thread) if(nr_block > 1)
+#endif
+	{
+		double *kvalue = collapsed? NULL : Malloc(double,(size_t)PREDICT_BLOCK*l);
+		double *scratch = Malloc(double,max(K.scratch_size(),1));
+		double *dec = Malloc(double,nr_dec);
+		int *start = Malloc(int,nr_class);
+		int *vote = Malloc(int,nr_class);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+		for(b=0;b<nr_block;b++)
+		{
+			int begin = b*PREDICT_BLOCK;
+			int m = min(PREDICT_BLOCK,n-begin);
+			if(!collapsed)
+				K.compute(m,&x[begin],kvalue,scratch);
+			for(int s=0;s<m;s++)
+			{
+				double *d = dec_values? &dec_values[(size_t)(begin+s)*nr_dec] : dec;
+				double pred;
+				if(collapsed)
+					pred = linear_predict_values(model,x[begin+s],d,vote);
+				else if(is_svc)
+					pred = svc_predict_kvalue(model,&kvalue[s*l],start,vote,d);
+				else
+				{
+					double *sv_coef = model->sv_coef[0];
+					double sum = 0;
+					const double *kv = &kvalue[s*l];
+					for(int i=0;i<l;i++)
+						sum += sv_coef[i] * kv[i];
+					sum -= model->rho[0];
+					d[0] = sum;
+					if(svm_type == ONE_CLASS)
+						pred = (sum>0)?1:-1;
+					else
+						pred = sum;
+				}
+				if(prob_estimates)
+					pred = svc_predict_probability_dec(model,d,&prob_estimates[(size_t)(begin+s)*nr_class]);
+				if(predictions)
+					predictions[begin+s] = pred;
+			}
+		}
+
+		free(kvalue);
+		free(scratch);
+		free(dec);
+		free(start);
+		free(vote);
 	}
-	else 
-		return svm_predict(model, x);
+}
+
+void svm_predict_values_batch(const svm_model *model, int n, svm_node * const *x, double *dec_values, double *predictions)
+{
+	svm_predict_batch_internal(model,n,x,dec_values,NULL,predictions);
+}
+
+void svm_predict_batch(const svm_model *model, int n, svm_node * const *x, double *predictions)
+{
+	svm_predict_batch_internal(model,n,x,NULL,NULL,predictions);
+}
+
+void svm_predict_probability_batch(const svm_model *model, int n, svm_node * const *x, double *prob_estimates, double *predictions)
+{
+	svm_predict_batch_internal(model,n,x,NULL,prob_estimates,predictions);
 }
 
 static const char *svm_type_table[] =
@@ -2777,6 +4722,9 @@ bool read_model_header(FILE *fp, svm_model* model)
 	param.nr_weight = 0;
 	param.weight_label = NULL;
 	param.weight = NULL;
+	param.nr_thread = 0;
+	param.single_precision = 0;
+	param.active_cache_size = 0;
 
 	char cmd[81];
 	while(1)
@@ -2884,11 +4832,20 @@ bool read_model_header(FILE *fp, svm_model* model)
 
 }
 
+static bool is_binary_file(FILE *fp);
+static svm_model *svm_load_model_binary(const char *model_file_name);
+
 svm_model *svm_load_model(const char *model_file_name)
 {
 	FILE *fp = fopen(model_file_name,"rb");
 	if(fp==NULL) return NULL;
 
+	if(is_binary_file(fp))
+	{
+		fclose(fp);
+		return svm_load_model_binary(model_file_name);
+	}
+
 	char *old_locale = setlocale(LC_ALL, NULL);
 	if (old_locale) {
 		old_locale = strdup(old_locale);
@@ -2902,6 +4859,8 @@ svm_model *svm_load_model(const char *model_file_name)
 	model->probA = NULL;
 	model->probB = NULL;
 	model->sv_indices = NULL;
+	model->w = NULL;
+	model->w_dim = 0;
 	model->label = NULL;
 	model->nSV = NULL;
 	
@@ -2989,11 +4948,447 @@ svm_model *svm_load_model(const char *model_file_name)
 		return NULL;
 
 	model->free_sv = 1;	// XXX
+	svm_collapse_linear(model);
 	return model;
 }
 
+//
+// Binary model and problem files
+//
+// A binary file is a header followed by arrays in a fixed order, each
+// padded to a multiple of 8 bytes so that every array is aligned when
+// the file is mapped. svm_node arrays are stored as they are in memory,
+// so a file can only be read on machines with the same byte order and
+// sizeof(svm_node); both are recorded in the header. A loaded file is
+// mapped read-only and used in place: only the pointer arrays SV,
+// sv_coef and prob->x are allocated, so processes loading the same
+// file share one copy in the page cache.
+//
+// model:   rho, [label], [probA], [probB], [nSV], sv_coef, sv_start, SV nodes
+// problem: y, x_start, nodes
+//
+// sv_start[i] and x_start[i] are the offsets of instance i in the nodes.
+//
+static const char binary_magic[8] = "libsvmb";
+#define BINARY_VERSION 1
+#define BINARY_BYTE_ORDER 0x01020304
+enum { BINARY_MODEL, BINARY_PROBLEM };
+enum { BINARY_LABEL = 1, BINARY_PROBA = 2, BINARY_PROBB = 4, BINARY_NSV = 8 };
+
+struct svm_binary_header
+{
+	char magic[8];
+	int version;
+	int type;		// BINARY_MODEL or BINARY_PROBLEM
+	int byte_order;		// BINARY_BYTE_ORDER as written
+	int node_size;		// sizeof(svm_node)
+	int svm_type;		// model only
+	int kernel_type;
+	int degree;
+	int nr_class;
+	int l;
+	int flags;		// BINARY_* arrays present in a model
+	double gamma;
+	double coef0;
+	long long elements;	// number of svm_node
+};
+
+struct svm_mapping
+{
+	char *base;
+	size_t size;
+	bool mapped;		// false if read into a malloc'd buffer
+};
+
+// Models and problems from binary files carry their mapping behind
+// the public struct; svm_free_model_content recognizes a model by
+// free_sv == 2.
+struct svm_mapped_model
+{
+	svm_model model;
+	svm_mapping map;
+};
+
+struct svm_mapped_problem
+{
+	svm_problem prob;
+	svm_mapping map;
+};
+
+static bool is_binary_file(FILE *fp)
+{
+	char magic[sizeof(binary_magic)];
+	bool ret = fread(magic,1,sizeof(magic),fp) == sizeof(magic) &&
+		memcmp(magic,binary_magic,sizeof(magic)) == 0;
+	rewind(fp);
+	return ret;
+}
+
+static bool svm_map_file(const char *filename, svm_mapping *map)
+{
+#ifndef _WIN32
+	int fd = open(filename,O_RDONLY);
+	if(fd < 0)
+		return false;
+	struct stat st;
+	if(fstat(fd,&st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+	{
+		void *base = mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_SHARED,fd,0);
+		close(fd);
+		if(base == MAP_FAILED)
+			return false;
+		map->base = (char *)base;
+		map->size = (size_t)st.st_size;
+		map->mapped = true;
+		return true;
+	}
+	close(fd);
+#endif
+	FILE *fp = fopen(filename,"rb");
+	if(fp == NULL)
+		return false;
+	size_t capacity = 1<<20, n;
+	map->base = Malloc(char,capacity);
+	map->size = 0;
+	map->mapped = false;
+	while((n = fread(map->base+map->size,1,capacity-map->size,fp)) > 0)
+	{
+		map->size += n;
+		if(map->size == capacity)
+		{
+			capacity *= 2;
+			map->base = (char *)realloc(map->base,capacity);
+		}
+	}
+	fclose(fp);
+	return true;
+}
+
+static void svm_unmap_file(svm_mapping *map)
+{
+#ifndef _WIN32
+	if(map->mapped)
+		munmap(map->base,map->size);
+	else
+#endif
+		free(map->base);
+	map->base = NULL;
+	map->size = 0;
+}
+
+static size_t binary_pad(size_t n)
+{
+	return (n+7) & ~(size_t)7;
+}
+
+static void binary_write(FILE *fp, const void *p, size_t n)
+{
+	static const char zero[8] = {0};
+	fwrite(p,1,n,fp);
+	fwrite(zero,1,binary_pad(n)-n,fp);
+}
+
+// the next n bytes at *pos, or NULL if the file is too short
+static const char *binary_read(const svm_mapping *map, size_t *pos, size_t n)
+{
+	if(binary_pad(n) > map->size-*pos)
+		return NULL;
+	const char *p = map->base+*pos;
+	*pos += binary_pad(n);
+	return p;
+}
+
+static void binary_init_header(svm_binary_header *h, int type)
+{
+	memset(h,0,sizeof(svm_binary_header));
+	memcpy(h->magic,binary_magic,sizeof(binary_magic));
+	h->version = BINARY_VERSION;
+	h->type = type;
+	h->byte_order = BINARY_BYTE_ORDER;
+	h->node_size = (int)sizeof(svm_node);
+}
+
+static const svm_binary_header *binary_read_header(const svm_mapping *map, size_t *pos, int type)
+{
+	const svm_binary_header *h = (const svm_binary_header *)binary_read(map,pos,sizeof(svm_binary_header));
+	if(h == NULL || memcmp(h->magic,binary_magic,sizeof(binary_magic)) != 0)
+		return NULL;
+	if(h->version != BINARY_VERSION || h->type != type ||
+	   h->byte_order != BINARY_BYTE_ORDER || h->node_size != (int)sizeof(svm_node))
+	{
+		fprintf(stderr,"unsupported binary file (version, byte order or svm_node size differ)\n");
+		return NULL;
+	}
+	if(h->l < 0 || h->elements < h->l || (unsigned long long)h->elements > map->size/sizeof(svm_node))
+		return NULL;
+	return h;
+}
+
+// Nodes of instance i are written from offset start[i]; the precomputed
+// kernel keeps only 0:serial_number as in the text format.
+static long long binary_node_offsets(int l, const svm_node * const *x, bool precomputed, long long *start)
+{
+	long long elements = 0;
+	for(int i=0;i<l;i++)
+	{
+		start[i] = elements;
+		if(precomputed)
+			elements += 2;
+		else
+		{
+			const svm_node *p = x[i];
+			while(p->index != -1)
+				p++;
+			elements += p-x[i]+1;
+		}
+	}
+	return elements;
+}
+
+static void binary_write_nodes(FILE *fp, int l, const svm_node * const *x, bool precomputed)
+{
+	svm_node node;
+	memset(&node,0,sizeof(node));	// no uninitialized padding in the file
+	for(int i=0;i<l;i++)
+	{
+		const svm_node *p = x[i];
+		for(;;p++)
+		{
+			node.index = (precomputed && p != x[i])? -1 : p->index;
+			node.value = (node.index == -1)? 0 : p->value;
+			fwrite(&node,sizeof(svm_node),1,fp);
+			if(node.index == -1)
+				break;
+		}
+	}
+}
+
+// instance pointers into nodes, or NULL if an offset is out of range
+static svm_node **binary_node_pointers(int l, const long long *start, const svm_node *nodes, long long elements)
+{
+	if(elements > 0 && nodes[elements-1].index != -1)
+		return NULL;
+	svm_node **x = Malloc(svm_node *,l);
+	for(int i=0;i<l;i++)
+	{
+		if(start[i] < 0 || start[i] >= elements || (i > 0 && start[i] <= start[i-1]))
+		{
+			free(x);
+			return NULL;
+		}
+		x[i] = (svm_node *)&nodes[start[i]];
+	}
+	return x;
+}
+
+int svm_save_model_binary(const char *model_file_name, const svm_model *model)
+{
+	FILE *fp = fopen(model_file_name,"wb");
+	if(fp==NULL) return -1;
+
+	const svm_parameter& param = model->param;
+	int nr_class = model->nr_class;
+	int l = model->l;
+	int n = nr_class*(nr_class-1)/2;
+	bool precomputed = (param.kernel_type == PRECOMPUTED);
+
+	svm_binary_header h;
+	binary_init_header(&h,BINARY_MODEL);
+	h.svm_type = param.svm_type;
+	h.kernel_type = param.kernel_type;
+	h.degree = param.degree;
+	h.gamma = param.gamma;
+	h.coef0 = param.coef0;
+	h.nr_class = nr_class;
+	h.l = l;
+	h.flags = (model->label? BINARY_LABEL : 0) | (model->probA? BINARY_PROBA : 0) |
+		(model->probB? BINARY_PROBB : 0) | (model->nSV? BINARY_NSV : 0);
+
+	long long *sv_start = Malloc(long long,l);
+	h.elements = binary_node_offsets(l,model->SV,precomputed,sv_start);
+
+	binary_write(fp,&h,sizeof(h));
+	binary_write(fp,model->rho,sizeof(double)*n);
+	if(model->label)
+		binary_write(fp,model->label,sizeof(int)*nr_class);
+	if(model->probA)
+		binary_write(fp,model->probA,sizeof(double)*n);
+	if(model->probB)
+		binary_write(fp,model->probB,sizeof(double)*n);
+	if(model->nSV)
+		binary_write(fp,model->nSV,sizeof(int)*nr_class);
+	for(int k=0;k<nr_class-1;k++)
+		binary_write(fp,model->sv_coef[k],sizeof(double)*l);
+	binary_write(fp,sv_start,sizeof(long long)*l);
+	binary_write_nodes(fp,l,model->SV,precomputed);
+	free(sv_start);
+
+	if (ferror(fp) != 0 || fclose(fp) != 0) return -1;
+	else return 0;
+}
+
+static svm_model *svm_load_model_binary(const char *model_file_name)
+{
+	svm_mapped_model *mapped = Malloc(svm_mapped_model,1);
+	if(!svm_map_file(model_file_name,&mapped->map))
+	{
+		free(mapped);
+		return NULL;
+	}
+
+	size_t pos = 0;
+	const svm_mapping *map = &mapped->map;
+	const svm_binary_header *h = binary_read_header(map,&pos,BINARY_MODEL);
+	svm_model *model = &mapped->model;
+	int nr_class = h? h->nr_class : 0;
+	int l = h? h->l : 0;
+	int n = nr_class*(nr_class-1)/2;
+	const double *sv_coef = NULL;
+	const long long *sv_start = NULL;
+	const svm_node *nodes = NULL;
+
+	memset(model,0,sizeof(svm_model));
+	if(h != NULL && nr_class >= 2)
+	{
+		svm_parameter& param = model->param;
+		param.svm_type = h->svm_type;
+		param.kernel_type = h->kernel_type;
+		param.degree = h->degree;
+		param.gamma = h->gamma;
+		param.coef0 = h->coef0;
+		model->nr_class = nr_class;
+		model->l = l;
+
+		model->rho = (double *)binary_read(map,&pos,sizeof(double)*n);
+		if(h->flags & BINARY_LABEL)
+			model->label = (int *)binary_read(map,&pos,sizeof(int)*nr_class);
+		if(h->flags & BINARY_PROBA)
+			model->probA = (double *)binary_read(map,&pos,sizeof(double)*n);
+		if(h->flags & BINARY_PROBB)
+			model->probB = (double *)binary_read(map,&pos,sizeof(double)*n);
+		if(h->flags & BINARY_NSV)
+			model->nSV = (int *)binary_read(map,&pos,sizeof(int)*nr_class);
+		sv_coef = (const double *)binary_read(map,&pos,sizeof(double)*l*(nr_class-1));
+		sv_start = (const long long *)binary_read(map,&pos,sizeof(long long)*l);
+		nodes = (const svm_node *)binary_read(map,&pos,sizeof(svm_node)*(size_t)h->elements);
+	}
+
+	if(nodes == NULL || model->rho == NULL ||
+	   ((h->flags & BINARY_LABEL) && model->label == NULL) ||
+	   ((h->flags & BINARY_PROBA) && model->probA == NULL) ||
+	   ((h->flags & BINARY_PROBB) && model->probB == NULL) ||
+	   ((h->flags & BINARY_NSV) && model->nSV == NULL) ||
+	   (model->SV = binary_node_pointers(l,sv_start,nodes,h->elements)) == NULL)
+	{
+		fprintf(stderr,"ERROR: failed to read binary model\n");
+		svm_unmap_file(&mapped->map);
+		free(mapped);
+		return NULL;
+	}
+
+	model->sv_coef = Malloc(double *,nr_class-1);
+	for(int k=0;k<nr_class-1;k++)
+		model->sv_coef[k] = (double *)&sv_coef[(size_t)k*l];
+	model->free_sv = 2;	// XXX
+	svm_collapse_linear(model);
+	return model;
+}
+
+int svm_save_problem(const char *problem_file_name, const svm_problem *prob)
+{
+	FILE *fp = fopen(problem_file_name,"wb");
+	if(fp==NULL) return -1;
+
+	int l = prob->l;
+	svm_binary_header h;
+	binary_init_header(&h,BINARY_PROBLEM);
+	h.l = l;
+
+	long long *x_start = Malloc(long long,l);
+	h.elements = binary_node_offsets(l,prob->x,false,x_start);
+
+	binary_write(fp,&h,sizeof(h));
+	binary_write(fp,prob->y,sizeof(double)*l);
+	binary_write(fp,x_start,sizeof(long long)*l);
+	binary_write_nodes(fp,l,prob->x,false);
+	free(x_start);
+
+	if (ferror(fp) != 0 || fclose(fp) != 0) return -1;
+	else return 0;
+}
+
+svm_problem *svm_load_problem(const char *problem_file_name)
+{
+	FILE *fp = fopen(problem_file_name,"rb");
+	if(fp==NULL) return NULL;
+	bool binary = is_binary_file(fp);
+	fclose(fp);
+	if(!binary)
+		return NULL;
+
+	svm_mapped_problem *mapped = Malloc(svm_mapped_problem,1);
+	if(!svm_map_file(problem_file_name,&mapped->map))
+	{
+		free(mapped);
+		return NULL;
+	}
+
+	size_t pos = 0;
+	const svm_mapping *map = &mapped->map;
+	const svm_binary_header *h = binary_read_header(map,&pos,BINARY_PROBLEM);
+	svm_problem *prob = &mapped->prob;
+	const long long *x_start = NULL;
+	const svm_node *nodes = NULL;
+
+	prob->x = NULL;
+	if(h != NULL)
+	{
+		prob->l = h->l;
+		prob->y = (double *)binary_read(map,&pos,sizeof(double)*h->l);
+		x_start = (const long long *)binary_read(map,&pos,sizeof(long long)*h->l);
+		nodes = (const svm_node *)binary_read(map,&pos,sizeof(svm_node)*(size_t)h->elements);
+		if(nodes != NULL && prob->y != NULL)
+			prob->x = binary_node_pointers(h->l,x_start,nodes,h->elements);
+	}
+	if(prob->x == NULL)
+	{
+		fprintf(stderr,"ERROR: failed to read binary problem\n");
+		svm_unmap_file(&mapped->map);
+		free(mapped);
+		return NULL;
+	}
+	return prob;
+}
+
+void svm_free_and_destroy_problem(svm_problem **prob_ptr_ptr)
+{
+	if(prob_ptr_ptr != NULL && *prob_ptr_ptr != NULL)
+	{
+		svm_mapped_problem *mapped = (svm_mapped_problem *)*prob_ptr_ptr;
+		free(mapped->prob.x);
+		svm_unmap_file(&mapped->map);
+		free(mapped);
+		*prob_ptr_ptr = NULL;
+	}
+}
+
 void svm_free_model_content(svm_model* model_ptr)
 {
+	if(model_ptr->free_sv == 2)
+	{
+		// only SV, sv_coef and w are allocated; the rest is in the mapped file
+		free(model_ptr->SV);
+		model_ptr->SV = NULL;
+		free(model_ptr->sv_coef);
+		model_ptr->sv_coef = NULL;
+		model_ptr->rho = NULL;
+		model_ptr->label = NULL;
+		model_ptr->probA = NULL;
+		model_ptr->probB = NULL;
+		model_ptr->nSV = NULL;
+		svm_unmap_file(&((svm_mapped_model *)model_ptr)->map);
+		model_ptr->free_sv = 0;
+	}
 	if(model_ptr->free_sv && model_ptr->l > 0 && model_ptr->SV != NULL)
 		free((void *)(model_ptr->SV[0]));
 	if(model_ptr->sv_coef)
@@ -3025,6 +5420,19 @@ void svm_free_model_content(svm_model* model_ptr)
 
 	free(model_ptr->nSV);
 	model_ptr->nSV = NULL;
+
+	if(model_ptr->w)
+	{
+		int nr_class = model_ptr->nr_class;
+		int svm_type = model_ptr->param.svm_type;
+		int nr_dec = nr_class*(nr_class-1)/2;
+		if(svm_type == ONE_CLASS || svm_type == EPSILON_SVR || svm_type == NU_SVR)
+			nr_dec = 1;
+		for(int i=0;i<nr_dec;i++)
+			free(model_ptr->w[i]);
+		free(model_ptr->w);
+		model_ptr->w = NULL;
+	}
 }
 
 void svm_free_and_destroy_model(svm_model** model_ptr_ptr)
@@ -3103,6 +5511,16 @@ const char *svm_check_parameter(const svm_problem *prob, const svm_parameter *pa
 	   param->probability != 1)
 		return "probability != 0 and probability != 1";
 
+	if(param->nr_thread < 0)
+		return "nr_thread < 0";
+
+	if(param->single_precision != 0 &&
+	   param->single_precision != 1)
+		return "single_precision != 0 and single_precision != 1";
+
+	if(param->active_cache_size < 0)
+		return "active_cache_size < 0";
+
 	if(param->probability == 1 &&
 	   svm_type == ONE_CLASS)
 		return "one-class SVM probability output not supported yet";
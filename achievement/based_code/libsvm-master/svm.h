@@ -1,7 +1,7 @@
 #ifndef _LIBSVM_H
 #define _LIBSVM_H
 
-#define LIBSVM_VERSION 322
+#define LIBSVM_VERSION 323
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,6 +44,9 @@ struct svm_parameter
 	double p;	/* for EPSILON_SVR */
 	int shrinking;	/* use the shrinking heuristics */
 	int probability; /* do probability estimates */
+	int nr_thread;	/* number of threads for kernel evaluation, 0 for the OpenMP default */
+	int single_precision;	/* evaluate kernels in single precision with SIMD */
+	double active_cache_size;	/* in MB, prefetch the active instances up to this size, 0 for none */
 };
 
 //
@@ -69,13 +72,31 @@ struct svm_model
 	/* XXX */
 	int free_sv;		/* 1 if svm_model is created by svm_load_model*/
 				/* 0 if svm_model is created by svm_train */
+				/* 2 if svm_model is mapped from a binary model file */
+
+	double **w;		/* linear kernel only: w[k*(k-1)/2][w_dim], sum of sv_coef*SV of each decision function, or NULL */
+	int w_dim;
 };
 
+struct svm_kernel_cache;	/* opaque, see svm_create_kernel_cache */
+
 struct svm_model *svm_train(const struct svm_problem *prob, const struct svm_parameter *param);
+struct svm_kernel_cache *svm_create_kernel_cache(const struct svm_problem *prob, const struct svm_parameter *param);
+void svm_destroy_kernel_cache(struct svm_kernel_cache *cache);
+struct svm_model *svm_train_warm(const struct svm_problem *prob, const struct svm_parameter *param, const struct svm_model *init_model, struct svm_kernel_cache *cache);
 void svm_cross_validation(const struct svm_problem *prob, const struct svm_parameter *param, int nr_fold, double *target);
+void svm_cross_validation_path(const struct svm_problem *prob, const struct svm_parameter *param, int nr_fold, int nr_C, const double *C, double *target);
+void svm_cross_validation_grid(const struct svm_problem *prob, const struct svm_parameter *param, int nr_fold, int nr_gamma, const double *gamma, int nr_C, const double *C, double *target);
+struct svm_model *svm_train_cross_validation(const struct svm_problem *prob, const struct svm_parameter *param, int nr_fold, double *target);
+struct svm_model *svm_train_pu_bsvm(const struct svm_problem *prob, const struct svm_parameter *param, int nr_fold, int nr_Cp, const double *Cp, int nr_Cn, const double *Cn, double *score, int *best);
+struct svm_model *svm_train_pu_iterative(const struct svm_problem *prob, const struct svm_parameter *param, double *label, int *nr_iter);
 
 int svm_save_model(const char *model_file_name, const struct svm_model *model);
 struct svm_model *svm_load_model(const char *model_file_name);
+int svm_save_model_binary(const char *model_file_name, const struct svm_model *model);
+int svm_save_problem(const char *problem_file_name, const struct svm_problem *prob);
+struct svm_problem *svm_load_problem(const char *problem_file_name);
+void svm_free_and_destroy_problem(struct svm_problem **prob_ptr_ptr);
 
 int svm_get_svm_type(const struct svm_model *model);
 int svm_get_nr_class(const struct svm_model *model);
@@ -87,6 +108,9 @@ double svm_get_svr_probability(const struct svm_model *model);
 double svm_predict_values(const struct svm_model *model, const struct svm_node *x, double* dec_values);
 double svm_predict(const struct svm_model *model, const struct svm_node *x);
 double svm_predict_probability(const struct svm_model *model, const struct svm_node *x, double* prob_estimates);
+void svm_predict_values_batch(const struct svm_model *model, int n, struct svm_node * const *x, double *dec_values, double *predictions);
+void svm_predict_batch(const struct svm_model *model, int n, struct svm_node * const *x, double *predictions);
+void svm_predict_probability_batch(const struct svm_model *model, int n, struct svm_node * const *x, double *prob_estimates, double *predictions);
 
 void svm_free_model_content(struct svm_model *model_ptr);
 void svm_free_and_destroy_model(struct svm_model **model_ptr_ptr);
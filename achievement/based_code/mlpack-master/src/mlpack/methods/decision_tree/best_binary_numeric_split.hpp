@@ -20,6 +20,19 @@ namespace tree {
 /**
  * The BestBinaryNumericSplit is a splitting function for decision trees that
  * will exhaustively search a numeric dimension for the best binary split.
+ * The dimension is sorted once, and then the class counts (or class weight
+ * sums) of the two children are updated point by point, so the search is
+ * O(n log n) for the sort and O(n * numClasses) for the scan.  This requires
+ * FitnessFunction to provide
+ *
+ * @code
+ * template<typename CountType>
+ * static double EvaluatePtr(const CountType* counts,
+ *                           const size_t numClasses,
+ *                           const CountType totalCount);
+ * @endcode
+ *
+ * as GiniGain and InformationGain do.
  *
  * @tparam FitnessFunction Fitness function to use to calculate gain.
  */
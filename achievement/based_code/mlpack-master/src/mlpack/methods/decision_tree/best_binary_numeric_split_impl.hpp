@@ -34,64 +34,64 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
 
   // Next, sort the data.
   arma::uvec sortedIndices = arma::sort_index(data);
-  arma::Row<size_t> sortedLabels(labels.n_elem);
-  arma::rowvec sortedWeights;
-  for (size_t i = 0; i < sortedLabels.n_elem; ++i)
-    sortedLabels[i] = labels[sortedIndices[i]];
 
-  // Only initialize if we are using weights.
+  // The points left of the split are swept from the right child into the left
+  // child one at a time, so each candidate split only needs the class counts
+  // (or class weight sums) of both children.
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  arma::vec rightCounts(numClasses, arma::fill::zeros);
+  double totalWeight = 0.0;
   if (UseWeights)
   {
-    sortedWeights.set_size(sortedLabels.n_elem);
-    // The weights must keep the same order as the labels.
-    for (size_t i = 0; i < sortedLabels.n_elem; ++i)
-      sortedWeights[i] = weights[sortedIndices[i]];
+    for (size_t i = 0; i < labels.n_elem; ++i)
+      rightCounts[labels[i]] += weights[i];
+    totalWeight = arma::accu(rightCounts);
+  }
+  else
+  {
+    for (size_t i = 0; i < labels.n_elem; ++i)
+      rightCounts[labels[i]]++;
+    totalWeight = (double) labels.n_elem;
   }
 
   // Loop through all possible split points, choosing the best one.  Also, force
   // a minimum leaf size of 1 (empty children don't make sense).
   double bestFoundGain = bestGain;
+  double leftWeight = 0.0;
   const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
-  for (size_t index = minimum; index < data.n_elem - (minimum - 1); ++index)
+  for (size_t index = 1; index < data.n_elem - (minimum - 1); ++index)
   {
+    // Move the point at index - 1 to the left child.
+    const size_t moved = sortedIndices[index - 1];
+    const double weight = UseWeights ? (double) weights[moved] : 1.0;
+    leftCounts[labels[moved]] += weight;
+    rightCounts[labels[moved]] -= weight;
+    leftWeight += weight;
+
+    if (index < minimum)
+      continue;
+
     // Make sure that the value has changed.
     if (data[sortedIndices[index]] == data[sortedIndices[index - 1]])
       continue;
 
-    // Calculate the gain for the left and right child.  Only use weights if
-    // needed.
-    const double leftGain = UseWeights ?
-        FitnessFunction::template Evaluate<true>(sortedLabels.subvec(0,
-            index - 1), numClasses, sortedWeights.subvec(0, index - 1)) :
-        FitnessFunction::template Evaluate<false>(sortedLabels.subvec(0,
-            index - 1), numClasses, sortedWeights /* ignored */);
-    const double rightGain = UseWeights ?
-        FitnessFunction::template Evaluate<true>(sortedLabels.subvec(index,
-            sortedLabels.n_elem - 1), numClasses, sortedWeights.subvec(index,
-            sortedLabels.n_elem - 1)) :
-        FitnessFunction::template Evaluate<false>(sortedLabels.subvec(index,
-            sortedLabels.n_elem - 1), numClasses, sortedWeights /* ignored */);
+    // Calculate the gain for the left and right child.  Subtracting weights
+    // can leave a tiny negative remainder, which is clamped.
+    const double rightWeight = UseWeights ?
+        std::max(totalWeight - leftWeight, 0.0) :
+        double(sortedIndices.n_elem - index);
+    const double leftGain = FitnessFunction::EvaluatePtr(leftCounts.memptr(),
+        numClasses, leftWeight);
+    const double rightGain = FitnessFunction::EvaluatePtr(
+        rightCounts.memptr(), numClasses, rightWeight);
 
-    double gain;
-    if (UseWeights)
-    {
-      const double leftWeights = arma::accu(sortedWeights.subvec(0, index - 1));
-      const double rightWeights = arma::accu(sortedWeights.subvec(index,
-          sortedWeights.n_elem - 1));
-      const double fullWeight = leftWeights + rightWeights;
-
-      gain = (leftWeights / fullWeight) * leftGain +
-          (rightWeights / fullWeight) * rightGain;
-    }
-    else
-    {
-      // Calculate the fraction of points in the left and right children.
-      const double leftRatio = double(index) / double(sortedLabels.n_elem);
-      const double rightRatio = 1.0 - leftRatio;
-
-      // Calculate the gain at this split point.
-      gain = leftRatio * leftGain + rightRatio * rightGain;
-    }
+    // Weight the gain of each child by its fraction of the points (or of the
+    // total weight).
+    const double fullWeight = leftWeight + rightWeight;
+    if (fullWeight == 0.0)
+      continue;
+    const double gain = (leftWeight / fullWeight) * leftGain +
+        (rightWeight / fullWeight) * rightGain;
 
     // Corner case: is this the best possible split?
     if (gain >= 0.0)
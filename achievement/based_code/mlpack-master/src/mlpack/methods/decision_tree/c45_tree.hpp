@@ -0,0 +1,419 @@
+/**
+ * @file c45_tree.hpp
+ *
+ * A C4.5 decision tree learner: gain ratio, multiway categorical splits,
+ * fractional instances for missing values and error-based pruning.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_C45_TREE_HPP
+#define MLPACK_METHODS_DECISION_TREE_C45_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "information_gain.hpp"
+#include "all_categorical_split.hpp"
+#include "class_statistics.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * This class implements the C4.5 decision tree learner (Quinlan, 1993).  At
+ * each node, every dimension is evaluated: numeric dimensions by the best
+ * binary threshold, categorical dimensions by a multiway split with one child
+ * per category (as with AllCategoricalSplit).  Among the dimensions whose gain
+ * is at least the average gain, the one of highest gain ratio is chosen.  The
+ * gain of a dimension is the impurity decrease (given by FitnessFunction,
+ * InformationGain by default) over the points whose value is known, times the
+ * fraction of such points; the split information counts the points of missing
+ * value as one more branch.  Thresholds are charged log2(t) / N for t
+ * candidate thresholds, as in release 8 of C4.5.
+ *
+ * Missing values are NaN.  A point of missing value in the split dimension
+ * goes down every child with its weight multiplied by the fraction of the
+ * known weight that went to that child, and a point of missing value in a
+ * split dimension is classified by all children, weighted the same way.
+ *
+ * Once grown, the tree is pruned by subtree replacement: a subtree is replaced
+ * by a leaf if the upper confidence bound on the errors of the leaf exceeds
+ * that of the subtree by at most 0.1.  Smaller confidence levels prune more; a
+ * confidence level of 1 disables pruning.
+ *
+ * The class counts of a node are computed from the weighted counts of its
+ * labels by StatisticsType.  With ClassStatistics, labels are classes; with
+ * PositiveOnlyStatistics, labels are positive (1) or unlabeled (0) and the
+ * class counts are estimated from the prior of the positive class, which gives
+ * POSC4.5 (Denis et al., 2005).
+ *
+ * When mlpack is compiled with OpenMP, the top levels of the tree are grown in
+ * one thread until there are a few pending subtrees per thread, and the
+ * pending subtrees are then grown in parallel.
+ *
+ * @code
+ * extern arma::mat data; // Missing values are NaN.
+ * extern data::DatasetInfo info;
+ * extern arma::Row<size_t> labels; // 1 for positive, 0 for unlabeled.
+ * C45Tree<InformationGain, AllCategoricalSplit, PositiveOnlyStatistics> tree(
+ *     data, info, labels, 2, 2, 0.25, PositiveOnlyStatistics(0.3));
+ * @endcode
+ *
+ * The class inherits from the auxiliary split information of the categorical
+ * split, as DecisionTree does.
+ *
+ * @tparam FitnessFunction Impurity of class counts; must provide
+ *     EvaluatePtr(), as GiniGain and InformationGain do.
+ * @tparam CategoricalSplitType Routing of categorical splits; its
+ *     NumChildren() must accept a vector holding the number of categories.
+ * @tparam StatisticsType Class counts of a node from its label counts.
+ */
+template<typename FitnessFunction = InformationGain,
+         template<typename> class CategoricalSplitType = AllCategoricalSplit,
+         typename StatisticsType = ClassStatistics>
+class C45Tree :
+    public CategoricalSplitType<FitnessFunction>::template
+        AuxiliarySplitInfo<double>
+{
+ public:
+  //! Allow access to the categorical split type.
+  typedef CategoricalSplitType<FitnessFunction> CategoricalSplit;
+
+  /**
+   * Construct and prune the tree on the given data and labels, where the data
+   * can be both numeric and categorical.
+   *
+   * @param data Dataset to train on; missing values are NaN.
+   * @param datasetInfo Type information for each dimension of the dataset.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes (and labels) in the dataset.
+   * @param minimumLeafSize Minimum weight of a branch of a split.
+   * @param confidence Confidence level of pruning, in (0, 1].
+   * @param statistics Statistics giving the class counts of a node.
+   */
+  template<typename MatType>
+  C45Tree(const MatType& data,
+          const data::DatasetInfo& datasetInfo,
+          const arma::Row<size_t>& labels,
+          const size_t numClasses,
+          const size_t minimumLeafSize = 2,
+          const double confidence = 0.25,
+          const StatisticsType& statistics = StatisticsType());
+
+  /**
+   * Construct and prune the tree on the given numeric data and labels.
+   *
+   * @param data Dataset to train on; missing values are NaN.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes (and labels) in the dataset.
+   * @param minimumLeafSize Minimum weight of a branch of a split.
+   * @param confidence Confidence level of pruning, in (0, 1].
+   * @param statistics Statistics giving the class counts of a node.
+   */
+  template<typename MatType>
+  C45Tree(const MatType& data,
+          const arma::Row<size_t>& labels,
+          const size_t numClasses,
+          const size_t minimumLeafSize = 2,
+          const double confidence = 0.25,
+          const StatisticsType& statistics = StatisticsType());
+
+  /**
+   * Construct a tree without training it.  It will be a leaf that predicts
+   * each class with equal probability.
+   *
+   * @param numClasses Number of classes.
+   */
+  C45Tree(const size_t numClasses = 1);
+
+  //! Copy another tree.
+  C45Tree(const C45Tree& other);
+  //! Take ownership of another tree.
+  C45Tree(C45Tree&& other);
+  //! Copy another tree.
+  C45Tree& operator=(const C45Tree& other);
+  //! Take ownership of another tree.
+  C45Tree& operator=(C45Tree&& other);
+
+  //! Clean up memory.
+  ~C45Tree();
+
+  /**
+   * Train and prune the tree on the given data and labels, where the data can
+   * be both numeric and categorical.
+   *
+   * @param data Dataset to train on; missing values are NaN.
+   * @param datasetInfo Type information for each dimension of the dataset.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes (and labels) in the dataset.
+   * @param minimumLeafSize Minimum weight of a branch of a split.
+   * @param confidence Confidence level of pruning, in (0, 1].
+   * @param statistics Statistics giving the class counts of a node.
+   */
+  template<typename MatType>
+  void Train(const MatType& data,
+             const data::DatasetInfo& datasetInfo,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const size_t minimumLeafSize = 2,
+             const double confidence = 0.25,
+             const StatisticsType& statistics = StatisticsType());
+
+  /**
+   * Train and prune the tree on the given numeric data and labels.
+   *
+   * @param data Dataset to train on; missing values are NaN.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes (and labels) in the dataset.
+   * @param minimumLeafSize Minimum weight of a branch of a split.
+   * @param confidence Confidence level of pruning, in (0, 1].
+   * @param statistics Statistics giving the class counts of a node.
+   */
+  template<typename MatType>
+  void Train(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const size_t minimumLeafSize = 2,
+             const double confidence = 0.25,
+             const StatisticsType& statistics = StatisticsType());
+
+  /**
+   * Prune the tree by subtree replacement at the given confidence level, and
+   * return the estimated number of errors of the pruned tree.  Train() already
+   * prunes the tree; this may prune it further with a smaller confidence.
+   *
+   * @param confidence Confidence level of pruning, in (0, 1).
+   */
+  double Prune(const double confidence);
+
+  /**
+   * Classify the given point, using the entire tree.  The predicted label is
+   * returned.
+   *
+   * @param point Point to classify; missing values are NaN.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point and also return estimates of the probability for
+   * each class in the given vector.
+   *
+   * @param point Point to classify; missing values are NaN.
+   * @param prediction This will be set to the predicted class of the point.
+   * @param probabilities This will be filled with class probabilities for the
+   *      point.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Classify the given points, using the entire tree.  The predicted labels for
+   * each point are stored in the given vector.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points and also return estimates of the probabilities
+   * for each class in the given matrix.  The predicted labels for each point
+   * are stored in the given vector.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities for each
+   *      point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  /**
+   * Serialize the tree.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  //! Get the number of children.
+  size_t NumChildren() const { return children.size(); }
+
+  //! Get the child of the given index.
+  const C45Tree& Child(const size_t i) const { return *children[i]; }
+  //! Modify the child of the given index (be careful!).
+  C45Tree& Child(const size_t i) { return *children[i]; }
+
+  //! Get the dimension this node splits on (if it is not a leaf).
+  size_t SplitDimension() const { return splitDimension; }
+  //! Get the fraction of the known training weight of each child.
+  const arma::vec& BranchWeights() const { return branchWeights; }
+  //! Get the class probabilities of the training points of this node.
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
+  //! Get the total class count of the training points of this node.
+  double TotalWeight() const { return totalWeight; }
+
+  /**
+   * Given a point and that this node is not a leaf, calculate the index of the
+   * child node this point would go towards.  If the value of the point in the
+   * split dimension is missing or an unseen category, the number of children
+   * is returned.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t CalculateDirection(const VecType& point) const;
+
+  /**
+   * Get the number of classes in the tree.
+   */
+  size_t NumClasses() const { return classProbabilities.n_elem; }
+
+  /**
+   * Return the number of errors to add to e errors out of n points to get the
+   * upper bound of the given confidence level on the errors, as in C4.5.
+   *
+   * @param n Total weight of the points.
+   * @param e Weight of the misclassified points.
+   * @param confidence Confidence level, in (0, 1).
+   */
+  static double AddedErrors(const double n,
+                            const double e,
+                            const double confidence);
+
+ private:
+  //! The vector of children.
+  std::vector<C45Tree*> children;
+  //! The dimension this node splits on.
+  size_t splitDimension;
+  //! The type of the dimension this node splits on.
+  size_t dimensionType;
+  //! The threshold of a numeric split, or the auxiliary information of the
+  //! categorical split (the number of categories).
+  arma::vec splitInfo;
+  //! The fraction of the known training weight of each child.
+  arma::vec branchWeights;
+  //! The class probabilities of the training points of this node.
+  arma::vec classProbabilities;
+  //! The total class count of the training points of this node.
+  double totalWeight;
+
+  //! The auxiliary information of the categorical split, held by inheritance.
+  typedef typename CategoricalSplit::template AuxiliarySplitInfo<double>
+      CategoricalAuxiliarySplitInfo;
+
+  //! A subtree left to grow, with its points and their weights.
+  struct PendingNode
+  {
+    C45Tree* node;
+    arma::uvec indices;
+    arma::vec weights;
+  };
+
+  /**
+   * Train and prune the tree; datasetInfo is NULL if all dimensions are
+   * numeric.
+   */
+  template<typename MatType>
+  void Train(const MatType& data,
+             const data::DatasetInfo* datasetInfo,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const size_t minimumLeafSize,
+             const double confidence,
+             const StatisticsType& statistics);
+
+  /**
+   * Grow the subtree of this node on the given points.  If pending is not
+   * NULL, nodes at depth maxDepth are not grown but added to pending.
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Type information for each dimension, or NULL if all
+   *     dimensions are numeric.
+   * @param labels Labels for each training point.
+   * @param numClasses Number of classes (and labels).
+   * @param statistics Statistics giving the class counts of a node.
+   * @param indices Indices of the points of this node; emptied.
+   * @param weights Weights of the points of this node; emptied.
+   * @param minimumLeafSize Minimum weight of a branch of a split.
+   * @param depth Depth of this node.
+   * @param maxDepth Depth of the nodes left to grow.
+   * @param pending Subtrees left to grow, or NULL to grow the whole subtree.
+   */
+  template<typename MatType>
+  void Grow(const MatType& data,
+            const data::DatasetInfo* datasetInfo,
+            const arma::Row<size_t>& labels,
+            const size_t numClasses,
+            const StatisticsType& statistics,
+            arma::uvec& indices,
+            arma::vec& weights,
+            const size_t minimumLeafSize,
+            const size_t depth,
+            const size_t maxDepth,
+            std::vector<PendingNode>* pending);
+
+  /**
+   * Evaluate the best binary threshold of a numeric dimension.  Returns false
+   * if no threshold leaves enough weight on both sides.
+   */
+  template<typename MatType>
+  static bool EvaluateNumeric(const MatType& data,
+                              const size_t dimension,
+                              const arma::Row<size_t>& labels,
+                              const size_t numClasses,
+                              const StatisticsType& statistics,
+                              const arma::uvec& indices,
+                              const arma::vec& weights,
+                              const double nodeSize,
+                              const size_t minimumLeafSize,
+                              double& gain,
+                              double& splitInformation,
+                              double& threshold);
+
+  /**
+   * Evaluate the multiway split of a categorical dimension.  Returns false if
+   * fewer than two categories hold enough weight.
+   */
+  template<typename MatType>
+  static bool EvaluateCategorical(const MatType& data,
+                                  const size_t dimension,
+                                  const size_t numCategories,
+                                  const arma::Row<size_t>& labels,
+                                  const size_t numClasses,
+                                  const StatisticsType& statistics,
+                                  const arma::uvec& indices,
+                                  const arma::vec& weights,
+                                  const double nodeSize,
+                                  const size_t minimumLeafSize,
+                                  double& gain,
+                                  double& splitInformation);
+
+  //! Return the impurity of the given class counts.
+  static double Impurity(const arma::vec& counts);
+
+  //! Return the split information of the given branch sizes.
+  static double SplitInformation(const arma::vec& sizes,
+                                 const double nodeSize);
+
+  //! Return the child the given value goes to, or the number of children.
+  size_t Direction(const double value) const;
+
+  //! Set probabilities to the class probabilities of the given point.
+  template<typename VecType>
+  void Distribution(const VecType& point, arma::vec& probabilities) const;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "c45_tree_impl.hpp"
+
+#endif
@@ -0,0 +1,897 @@
+/**
+ * @file c45_tree_impl.hpp
+ *
+ * Implementation of the C4.5 decision tree learner.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_C45_TREE_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_C45_TREE_IMPL_HPP
+
+// In case it hasn't been included already.
+#include "c45_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+//! Construct and prune the tree on mixed categorical and numeric data.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename MatType>
+C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::C45Tree(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double confidence,
+    const StatisticsType& statistics) :
+    splitDimension(0),
+    dimensionType(0),
+    totalWeight(0.0)
+{
+  Train(data, &datasetInfo, labels, numClasses, minimumLeafSize, confidence,
+      statistics);
+}
+
+//! Construct and prune the tree on numeric data.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename MatType>
+C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::C45Tree(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double confidence,
+    const StatisticsType& statistics) :
+    splitDimension(0),
+    dimensionType(0),
+    totalWeight(0.0)
+{
+  Train(data, (const data::DatasetInfo*) NULL, labels, numClasses,
+      minimumLeafSize, confidence, statistics);
+}
+
+//! Construct a leaf.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::C45Tree(
+    const size_t numClasses) :
+    splitDimension(0),
+    dimensionType(0),
+    totalWeight(0.0)
+{
+  // Initialize utility vector.
+  classProbabilities.ones(numClasses);
+  classProbabilities /= numClasses;
+}
+
+//! Copy another tree.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::C45Tree(
+    const C45Tree& other) :
+    CategoricalAuxiliarySplitInfo(other),
+    splitDimension(other.splitDimension),
+    dimensionType(other.dimensionType),
+    splitInfo(other.splitInfo),
+    branchWeights(other.branchWeights),
+    classProbabilities(other.classProbabilities),
+    totalWeight(other.totalWeight)
+{
+  // Copy each child.
+  for (size_t i = 0; i < other.children.size(); ++i)
+    children.push_back(new C45Tree(*other.children[i]));
+}
+
+//! Take ownership of another tree.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::C45Tree(
+    C45Tree&& other) :
+    CategoricalAuxiliarySplitInfo(std::move(other)),
+    children(std::move(other.children)),
+    splitDimension(other.splitDimension),
+    dimensionType(other.dimensionType),
+    splitInfo(std::move(other.splitInfo)),
+    branchWeights(std::move(other.branchWeights)),
+    classProbabilities(std::move(other.classProbabilities)),
+    totalWeight(other.totalWeight)
+{
+  // Reset the other object.
+  other.classProbabilities.ones(1); // One class, P(1) = 1.
+  other.totalWeight = 0.0;
+}
+
+//! Copy another tree.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>&
+C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::operator=(
+    const C45Tree& other)
+{
+  if (this == &other)
+    return *this; // Nothing to copy.
+
+  // Clean memory if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+
+  // Copy everything from the other tree.
+  splitDimension = other.splitDimension;
+  dimensionType = other.dimensionType;
+  splitInfo = other.splitInfo;
+  branchWeights = other.branchWeights;
+  classProbabilities = other.classProbabilities;
+  totalWeight = other.totalWeight;
+
+  // Copy the children.
+  for (size_t i = 0; i < other.children.size(); ++i)
+    children.push_back(new C45Tree(*other.children[i]));
+
+  // Copy the auxiliary info.
+  CategoricalAuxiliarySplitInfo::operator=(other);
+
+  return *this;
+}
+
+//! Take ownership of another tree.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>&
+C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::operator=(
+    C45Tree&& other)
+{
+  if (this == &other)
+    return *this; // Nothing to move.
+
+  // Clean memory if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+
+  // Take ownership of the other tree's components.
+  children = std::move(other.children);
+  splitDimension = other.splitDimension;
+  dimensionType = other.dimensionType;
+  splitInfo = std::move(other.splitInfo);
+  branchWeights = std::move(other.branchWeights);
+  classProbabilities = std::move(other.classProbabilities);
+  totalWeight = other.totalWeight;
+
+  // Reset the other object.
+  other.classProbabilities.ones(1); // One class, P(1) = 1.
+  other.totalWeight = 0.0;
+
+  // Take ownership of the auxiliary info.
+  CategoricalAuxiliarySplitInfo::operator=(std::move(other));
+
+  return *this;
+}
+
+//! Clean up memory.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::~C45Tree()
+{
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+}
+
+//! Train and prune the tree on mixed categorical and numeric data.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename MatType>
+void C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::Train(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double confidence,
+    const StatisticsType& statistics)
+{
+  Train(data, &datasetInfo, labels, numClasses, minimumLeafSize, confidence,
+      statistics);
+}
+
+//! Train and prune the tree on numeric data.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename MatType>
+void C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double confidence,
+    const StatisticsType& statistics)
+{
+  Train(data, (const data::DatasetInfo*) NULL, labels, numClasses,
+      minimumLeafSize, confidence, statistics);
+}
+
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename MatType>
+void C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::Train(
+    const MatType& data,
+    const data::DatasetInfo* datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double confidence,
+    const StatisticsType& statistics)
+{
+  if (labels.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "C45Tree::Train(): number of labels (" << labels.n_elem << ") "
+        << "does not match number of points (" << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (confidence <= 0.0 || confidence > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "C45Tree::Train(): confidence must be in (0, 1], but "
+        << confidence << " was given!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Clean memory if needed.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+  splitInfo.reset();
+  branchWeights.reset();
+
+  // The statistics may learn from the labels of all points.
+  arma::vec labelCounts(numClasses, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labelCounts[labels[i]] += 1.0;
+  StatisticsType treeStatistics(statistics);
+  treeStatistics.Initialize(labelCounts);
+
+  classProbabilities.ones(numClasses);
+  classProbabilities /= numClasses;
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
+  arma::vec weights(data.n_cols, arma::fill::ones);
+
+  // Grow the top of the tree in this thread, until there are a few subtrees
+  // per thread left to grow; then grow those in parallel.
+  size_t maxDepth = 0;
+  #ifdef HAS_OPENMP
+    maxDepth = (size_t) std::ceil(std::log2(4.0 * omp_get_max_threads()));
+  #endif
+
+  std::vector<PendingNode> pending;
+  Grow(data, datasetInfo, labels, numClasses, treeStatistics, indices, weights,
+      minimumLeafSize, 0, maxDepth, &pending);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) pending.size(); ++i)
+  {
+    pending[i].node->Grow(data, datasetInfo, labels, numClasses,
+        treeStatistics, pending[i].indices, pending[i].weights,
+        minimumLeafSize, 0, 0, NULL);
+  }
+
+  if (confidence < 1.0)
+    Prune(confidence);
+}
+
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename MatType>
+void C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::Grow(
+    const MatType& data,
+    const data::DatasetInfo* datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const StatisticsType& statistics,
+    arma::uvec& indices,
+    arma::vec& weights,
+    const size_t minimumLeafSize,
+    const size_t depth,
+    const size_t maxDepth,
+    std::vector<PendingNode>* pending)
+{
+  arma::vec labelCounts(numClasses, arma::fill::zeros);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    labelCounts[labels[indices[i]]] += weights[i];
+  arma::vec classCounts;
+  statistics.ClassCounts(labelCounts, classCounts);
+
+  // An empty node keeps the class probabilities of its parent.
+  totalWeight = arma::accu(classCounts);
+  if (totalWeight > 0.0)
+    classProbabilities = classCounts / totalWeight;
+
+  // Small and pure nodes are leaves.
+  if (totalWeight < 2 * minimumLeafSize ||
+      arma::max(classCounts) >= totalWeight)
+    return;
+
+  if (pending != NULL && depth == maxDepth)
+  {
+    pending->push_back(PendingNode());
+    pending->back().node = this;
+    pending->back().indices.swap(indices);
+    pending->back().weights.swap(weights);
+    return;
+  }
+
+  // Evaluate every dimension.
+  arma::vec gains(data.n_rows, arma::fill::zeros);
+  arma::vec splitInformations(data.n_rows, arma::fill::zeros);
+  arma::vec thresholds(data.n_rows, arma::fill::zeros);
+  std::vector<bool> possible(data.n_rows, false);
+  double gainSum = 0.0;
+  size_t numPossible = 0;
+  for (size_t d = 0; d < data.n_rows; ++d)
+  {
+    if (datasetInfo != NULL &&
+        datasetInfo->Type(d) == data::Datatype::categorical)
+    {
+      possible[d] = EvaluateCategorical(data, d, datasetInfo->NumMappings(d),
+          labels, numClasses, statistics, indices, weights, totalWeight,
+          minimumLeafSize, gains[d], splitInformations[d]);
+    }
+    else
+    {
+      possible[d] = EvaluateNumeric(data, d, labels, numClasses, statistics,
+          indices, weights, totalWeight, minimumLeafSize, gains[d],
+          splitInformations[d], thresholds[d]);
+    }
+
+    if (possible[d])
+    {
+      gainSum += gains[d];
+      ++numPossible;
+    }
+  }
+
+  if (numPossible == 0)
+    return;
+
+  // Take the best gain ratio among the dimensions of at least average gain.
+  const double averageGain = gainSum / numPossible;
+  size_t bestDimension = data.n_rows;
+  double bestRatio = 0.0;
+  for (size_t d = 0; d < data.n_rows; ++d)
+  {
+    if (!possible[d] || gains[d] <= 0.0 || splitInformations[d] <= 0.0 ||
+        gains[d] < averageGain - 1e-3)
+      continue;
+
+    const double ratio = gains[d] / splitInformations[d];
+    if (ratio > bestRatio)
+    {
+      bestRatio = ratio;
+      bestDimension = d;
+    }
+  }
+
+  if (bestDimension == data.n_rows)
+    return;
+
+  // Split the node.
+  splitDimension = bestDimension;
+  splitInfo.set_size(1);
+  size_t numChildren;
+  if (datasetInfo != NULL &&
+      datasetInfo->Type(splitDimension) == data::Datatype::categorical)
+  {
+    dimensionType = (size_t) data::Datatype::categorical;
+    splitInfo[0] = datasetInfo->NumMappings(splitDimension);
+    numChildren = CategoricalSplit::NumChildren(splitInfo, *this);
+  }
+  else
+  {
+    dimensionType = (size_t) data::Datatype::numeric;
+    splitInfo[0] = thresholds[splitDimension];
+    numChildren = 2;
+  }
+
+  for (size_t c = 0; c < numChildren; ++c)
+  {
+    children.push_back(new C45Tree(numClasses));
+    children[c]->classProbabilities = classProbabilities;
+  }
+
+  // Route the points of known value, and find the fraction of the known
+  // weight that goes to each child.
+  arma::Col<size_t> directions(indices.n_elem);
+  arma::mat childLabelCounts(numClasses, numChildren, arma::fill::zeros);
+  arma::Col<size_t> childPoints(numChildren, arma::fill::zeros);
+  size_t numMissing = 0;
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    directions[i] = Direction(data(splitDimension, indices[i]));
+    if (directions[i] < numChildren)
+    {
+      childLabelCounts(labels[indices[i]], directions[i]) += weights[i];
+      ++childPoints[directions[i]];
+    }
+    else
+    {
+      ++numMissing;
+    }
+  }
+
+  branchWeights.set_size(numChildren);
+  for (size_t c = 0; c < numChildren; ++c)
+  {
+    const arma::vec childLabels = childLabelCounts.col(c);
+    statistics.ClassCounts(childLabels, classCounts);
+    branchWeights[c] = arma::accu(classCounts);
+  }
+  const double knownWeight = arma::accu(branchWeights);
+  if (knownWeight > 0.0)
+    branchWeights /= knownWeight;
+
+  // Points of missing value go down every child of known weight, with their
+  // weight scaled by the fraction of that child.
+  std::vector<arma::uvec> childIndices(numChildren);
+  std::vector<arma::vec> childWeights(numChildren);
+  for (size_t c = 0; c < numChildren; ++c)
+  {
+    const size_t numPoints = childPoints[c] +
+        ((branchWeights[c] > 0.0) ? numMissing : 0);
+    childIndices[c].set_size(numPoints);
+    childWeights[c].set_size(numPoints);
+
+    size_t k = 0;
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      if (directions[i] == c)
+      {
+        childIndices[c][k] = indices[i];
+        childWeights[c][k++] = weights[i];
+      }
+      else if (directions[i] == numChildren && branchWeights[c] > 0.0)
+      {
+        childIndices[c][k] = indices[i];
+        childWeights[c][k++] = weights[i] * branchWeights[c];
+      }
+    }
+  }
+
+  // The points of this node are no longer needed.
+  indices.reset();
+  weights.reset();
+
+  for (size_t c = 0; c < numChildren; ++c)
+  {
+    children[c]->Grow(data, datasetInfo, labels, numClasses, statistics,
+        childIndices[c], childWeights[c], minimumLeafSize, depth + 1, maxDepth,
+        pending);
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename MatType>
+bool C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    EvaluateNumeric(const MatType& data,
+                    const size_t dimension,
+                    const arma::Row<size_t>& labels,
+                    const size_t numClasses,
+                    const StatisticsType& statistics,
+                    const arma::uvec& indices,
+                    const arma::vec& weights,
+                    const double nodeSize,
+                    const size_t minimumLeafSize,
+                    double& gain,
+                    double& splitInformation,
+                    double& threshold)
+{
+  // Collect the points of known value.
+  std::vector<std::pair<double, size_t>> known;
+  known.reserve(indices.n_elem);
+  arma::vec knownLabels(numClasses, arma::fill::zeros);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    const double value = data(dimension, indices[i]);
+    if (std::isnan(value))
+      continue;
+
+    known.push_back(std::make_pair(value, i));
+    knownLabels[labels[indices[i]]] += weights[i];
+  }
+
+  arma::vec knownCounts;
+  statistics.ClassCounts(knownLabels, knownCounts);
+  const double knownSize = arma::accu(knownCounts);
+
+  // As in C4.5, each side must hold a tenth of the weight per class, between
+  // minimumLeafSize and 25.
+  const double minimumSize = std::max((double) minimumLeafSize,
+      std::min(25.0, 0.1 * knownSize / numClasses));
+  if (knownSize < 2 * minimumSize)
+    return false;
+
+  std::sort(known.begin(), known.end());
+  const double baseImpurity = Impurity(knownCounts);
+
+  // Sweep the thresholds between distinct values.
+  arma::vec leftLabels(numClasses, arma::fill::zeros);
+  arma::vec rightLabels, leftCounts, rightCounts;
+  double bestInfo = -DBL_MAX, bestLeftSize = 0.0, bestRightSize = 0.0;
+  size_t tries = 0;
+  for (size_t k = 0; k + 1 < known.size(); ++k)
+  {
+    const size_t i = known[k].second;
+    leftLabels[labels[indices[i]]] += weights[i];
+    if (known[k].first == known[k + 1].first)
+      continue;
+
+    rightLabels = knownLabels - leftLabels;
+    statistics.ClassCounts(leftLabels, leftCounts);
+    statistics.ClassCounts(rightLabels, rightCounts);
+    const double leftSize = arma::accu(leftCounts);
+    const double rightSize = arma::accu(rightCounts);
+    if (leftSize < minimumSize || rightSize < minimumSize)
+      continue;
+
+    ++tries;
+    const double info = baseImpurity - (leftSize * Impurity(leftCounts) +
+        rightSize * Impurity(rightCounts)) / knownSize;
+    if (info > bestInfo)
+    {
+      bestInfo = info;
+      bestLeftSize = leftSize;
+      bestRightSize = rightSize;
+      threshold = (known[k].first + known[k + 1].first) / 2.0;
+    }
+  }
+
+  if (tries == 0)
+    return false;
+
+  gain = knownSize / nodeSize * bestInfo - std::log2((double) tries) / nodeSize;
+
+  arma::vec sizes(3);
+  sizes[0] = bestLeftSize;
+  sizes[1] = bestRightSize;
+  sizes[2] = nodeSize - knownSize;
+  splitInformation = SplitInformation(sizes, nodeSize);
+  return true;
+}
+
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename MatType>
+bool C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    EvaluateCategorical(const MatType& data,
+                        const size_t dimension,
+                        const size_t numCategories,
+                        const arma::Row<size_t>& labels,
+                        const size_t numClasses,
+                        const StatisticsType& statistics,
+                        const arma::uvec& indices,
+                        const arma::vec& weights,
+                        const double nodeSize,
+                        const size_t minimumLeafSize,
+                        double& gain,
+                        double& splitInformation)
+{
+  arma::mat categoryLabels(numClasses, numCategories, arma::fill::zeros);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    const double value = data(dimension, indices[i]);
+    if (std::isnan(value) || value < 0.0 || value >= numCategories)
+      continue;
+
+    categoryLabels(labels[indices[i]], (size_t) value) += weights[i];
+  }
+
+  // One branch per category, and one for the points of missing value.
+  arma::vec sizes(numCategories + 1);
+  arma::vec counts;
+  double childImpurity = 0.0;
+  size_t reasonableCategories = 0;
+  for (size_t c = 0; c < numCategories; ++c)
+  {
+    const arma::vec labelCounts = categoryLabels.col(c);
+    statistics.ClassCounts(labelCounts, counts);
+    sizes[c] = arma::accu(counts);
+    childImpurity += sizes[c] * Impurity(counts);
+    if (sizes[c] >= minimumLeafSize)
+      ++reasonableCategories;
+  }
+
+  if (reasonableCategories < 2)
+    return false;
+
+  const arma::vec knownLabels = arma::sum(categoryLabels, 1);
+  statistics.ClassCounts(knownLabels, counts);
+  const double knownSize = arma::accu(counts);
+  sizes[numCategories] = nodeSize - knownSize;
+
+  gain = knownSize / nodeSize * (Impurity(counts) - childImpurity / knownSize);
+  splitInformation = SplitInformation(sizes, nodeSize);
+  return true;
+}
+
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+double C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    Impurity(const arma::vec& counts)
+{
+  return -FitnessFunction::EvaluatePtr(counts.memptr(), counts.n_elem,
+      arma::accu(counts));
+}
+
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+double C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    SplitInformation(const arma::vec& sizes, const double nodeSize)
+{
+  double info = 0.0;
+  for (size_t i = 0; i < sizes.n_elem; ++i)
+  {
+    if (sizes[i] > 0.0)
+    {
+      const double f = sizes[i] / nodeSize;
+      info -= f * std::log2(f);
+    }
+  }
+
+  return info;
+}
+
+//! Prune the tree by subtree replacement.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+double C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::Prune(
+    const double confidence)
+{
+  const double errors = totalWeight * (1.0 - arma::max(classProbabilities));
+  const double leafErrors = errors + AddedErrors(totalWeight, errors,
+      confidence);
+  if (children.empty())
+    return leafErrors;
+
+  double subtreeErrors = 0.0;
+  for (size_t i = 0; i < children.size(); ++i)
+    subtreeErrors += children[i]->Prune(confidence);
+
+  if (leafErrors > subtreeErrors + 0.1)
+    return subtreeErrors;
+
+  // Replace the subtree by a leaf.
+  for (size_t i = 0; i < children.size(); ++i)
+    delete children[i];
+  children.clear();
+  splitInfo.reset();
+  branchWeights.reset();
+
+  return leafErrors;
+}
+
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+double C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    AddedErrors(const double n, const double e, const double confidence)
+{
+  // Normal deviates of upper tail probabilities, to interpolate from.
+  static const double values[] = { 0.0, 0.001, 0.005, 0.01, 0.05, 0.10, 0.20,
+      0.40, 1.00 };
+  static const double deviations[] = { 4.0, 3.09, 2.58, 2.33, 1.65, 1.28,
+      0.84, 0.25, 0.00 };
+
+  if (n <= 0.0)
+    return 0.0;
+
+  if (e < 1e-6)
+    return n * (1.0 - std::exp(std::log(confidence) / n));
+
+  if (e < 0.9999)
+  {
+    const double none = n * (1.0 - std::exp(std::log(confidence) / n));
+    return none + e * (AddedErrors(n, 1.0, confidence) - none);
+  }
+
+  if (e + 0.5 >= n)
+    return 0.67 * (n - e);
+
+  size_t i = 1;
+  while (i < 8 && confidence > values[i])
+    ++i;
+  const double z = deviations[i - 1] + (deviations[i] - deviations[i - 1]) *
+      (confidence - values[i - 1]) / (values[i] - values[i - 1]);
+  const double z2 = z * z;
+
+  const double p = (e + 0.5 + z2 / 2.0 + std::sqrt(z2 * ((e + 0.5) *
+      (1.0 - (e + 0.5) / n) + z2 / 4.0))) / (n + z2);
+  return n * p - e;
+}
+
+//! Return the class of the given point.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename VecType>
+size_t C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    Classify(const VecType& point) const
+{
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+  return prediction;
+}
+
+//! Return the class and the class probabilities of the given point.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename VecType>
+void C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    Classify(const VecType& point,
+             size_t& prediction,
+             arma::vec& probabilities) const
+{
+  Distribution(point, probabilities);
+
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+  prediction = (size_t) maxIndex;
+}
+
+//! Return the class of each of the given points.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename MatType>
+void C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    Classify(const MatType& data, arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+//! Return the class and the class probabilities of each of the given points.
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename MatType>
+void C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    Classify(const MatType& data,
+             arma::Row<size_t>& predictions,
+             arma::mat& probabilities) const
+{
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(NumClasses(), data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    Classify(data.col(i), prediction, pointProbabilities);
+    predictions[i] = prediction;
+    probabilities.col(i) = pointProbabilities;
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename VecType>
+void C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    Distribution(const VecType& point, arma::vec& probabilities) const
+{
+  if (children.empty())
+  {
+    probabilities = classProbabilities;
+    return;
+  }
+
+  const size_t direction = CalculateDirection(point);
+  if (direction < children.size())
+  {
+    children[direction]->Distribution(point, probabilities);
+    return;
+  }
+
+  // The value is missing, so combine the children.
+  probabilities.zeros(classProbabilities.n_elem);
+  arma::vec childProbabilities;
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    if (branchWeights[i] > 0.0)
+    {
+      children[i]->Distribution(point, childProbabilities);
+      probabilities += branchWeights[i] * childProbabilities;
+    }
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename VecType>
+size_t C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    CalculateDirection(const VecType& point) const
+{
+  return Direction((double) point[splitDimension]);
+}
+
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+size_t C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    Direction(const double value) const
+{
+  if (std::isnan(value))
+    return children.size();
+
+  if ((data::Datatype) dimensionType == data::Datatype::categorical)
+  {
+    // Unseen categories are treated as missing.
+    if (value < 0.0 || value >= splitInfo[0])
+      return children.size();
+
+    return std::min(CategoricalSplit::CalculateDirection(value, splitInfo,
+        *this), children.size());
+  }
+
+  return (value <= splitInfo[0]) ? 0 : 1;
+}
+
+template<typename FitnessFunction,
+         template<typename> class CategoricalSplitType,
+         typename StatisticsType>
+template<typename Archive>
+void C45Tree<FitnessFunction, CategoricalSplitType, StatisticsType>::
+    serialize(Archive& ar, const unsigned int /* version */)
+{
+  // Clean memory if needed.
+  if (Archive::is_loading::value)
+  {
+    for (size_t i = 0; i < children.size(); ++i)
+      delete children[i];
+    children.clear();
+  }
+
+  // Serialize the children first.
+  ar & BOOST_SERIALIZATION_NVP(children);
+
+  // Now serialize the rest of the object.
+  ar & BOOST_SERIALIZATION_NVP(splitDimension);
+  ar & BOOST_SERIALIZATION_NVP(dimensionType);
+  ar & BOOST_SERIALIZATION_NVP(splitInfo);
+  ar & BOOST_SERIALIZATION_NVP(branchWeights);
+  ar & BOOST_SERIALIZATION_NVP(classProbabilities);
+  ar & BOOST_SERIALIZATION_NVP(totalWeight);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
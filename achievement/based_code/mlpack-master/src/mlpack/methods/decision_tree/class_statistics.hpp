@@ -0,0 +1,49 @@
+/**
+ * @file class_statistics.hpp
+ *
+ * The ClassStatistics class, which gives the class counts of a node of a
+ * C45Tree from the counts of the labels of its points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_CLASS_STATISTICS_HPP
+#define MLPACK_METHODS_DECISION_TREE_CLASS_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The statistics of supervised learning: each label is a class, so the class
+ * counts of a node are the (weighted) counts of its labels.  A statistics
+ * class for C45Tree provides
+ *
+ * @code
+ * // Called once with the label counts of all training points.
+ * void Initialize(const arma::vec& labelCounts);
+ * // Set classCounts to the class counts of a node with the given label
+ * // counts.
+ * void ClassCounts(const arma::vec& labelCounts, arma::vec& classCounts) const;
+ * @endcode
+ */
+class ClassStatistics
+{
+ public:
+  //! Nothing to learn from the training points.
+  void Initialize(const arma::vec& /* labelCounts */) { }
+
+  //! The class counts are the label counts.
+  void ClassCounts(const arma::vec& labelCounts, arma::vec& classCounts) const
+  {
+    classCounts = labelCounts;
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -379,6 +379,11 @@ class DecisionTree :
   typedef typename CategoricalSplit::template AuxiliarySplitInfo<ElemType>
       CategoricalAuxiliarySplitInfo;
 
+  //! RandomForest trains its trees on bootstrap indices of one dataset.
+  template<typename, typename, template<typename> class,
+           template<typename> class, typename>
+  friend class RandomForest;
+
   /**
    * Calculate the class probabilities of the given labels.
    */
@@ -392,9 +397,13 @@ class DecisionTree :
    * avoiding unnecessary copies during training.  This function is called to
    * train children.
    *
-   * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param data Dataset to train on; it is not modified.
+   * @param indices Indices of the points of the dataset; the point at position
+   *      k is data.col(indices[k]), with label labels[k] and weight
+   *      weights[k].  Positions begin to begin + count - 1 are reordered so
+   *      that the points of each child are contiguous.
+   * @param begin Position of the first point in indices that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param datasetInfo Type information for each dimension.
    * @param labels Labels for each training point.
@@ -403,7 +412,8 @@ class DecisionTree :
    * @param minimumGainSplit Minimum gain for the node to split.
    */
   template<bool UseWeights, typename MatType>
-  void Train(MatType& data,
+  void Train(const MatType& data,
+             arma::uvec& indices,
              const size_t begin,
              const size_t count,
              const data::DatasetInfo& datasetInfo,
@@ -418,9 +428,13 @@ class DecisionTree :
    * avoiding unnecessary copies during training.  This method is called for
    * training children.
    *
-   * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param data Dataset to train on; it is not modified.
+   * @param indices Indices of the points of the dataset; the point at position
+   *      k is data.col(indices[k]), with label labels[k] and weight
+   *      weights[k].  Positions begin to begin + count - 1 are reordered so
+   *      that the points of each child are contiguous.
+   * @param begin Position of the first point in indices that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
@@ -428,7 +442,8 @@ class DecisionTree :
    * @param minimumGainSplit Minimum gain for the node to split.
    */
   template<bool UseWeights, typename MatType>
-  void Train(MatType& data,
+  void Train(const MatType& data,
+             arma::uvec& indices,
              const size_t begin,
              const size_t count,
              arma::Row<size_t>& labels,
@@ -35,17 +35,18 @@ DecisionTree<FitnessFunction,
                                         const size_t minimumLeafSize,
                                         const double minimumGainSplit)
 {
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::forward<MatType>(data));
+  // Copy or move the labels.  The data itself is not copied; the nodes reorder
+  // the indices of its points instead.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      weights, minimumLeafSize, minimumGainSplit);
+  Train<false>(data, indices, 0, data.n_cols, datasetInfo, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit);
 }
 
 //! Construct and train.
@@ -67,16 +68,17 @@ DecisionTree<FitnessFunction,
                                         const size_t minimumLeafSize,
                                         const double minimumGainSplit)
 {
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::forward<MatType>(data));
+  // Copy or move the labels.  The data itself is not copied; the nodes reorder
+  // the indices of its points instead.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, weights,
+  Train<false>(data, indices, 0, data.n_cols, tmpLabels, numClasses, weights,
       minimumLeafSize, minimumGainSplit);
 }
 
@@ -105,17 +107,18 @@ DecisionTree<FitnessFunction,
                                             typename std::remove_reference<
                                             WeightsType>::type>::value>*)
 {
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
   using TrueWeightsType = typename std::decay<WeightsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::forward<MatType>(data));
+  // Copy or move the labels.  The data itself is not copied; the nodes reorder
+  // the indices of its points instead.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
   TrueWeightsType tmpWeights(std::forward<WeightsType>(weights));
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
+  Train<true>(data, indices, 0, data.n_cols, datasetInfo, tmpLabels, numClasses,
       tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
@@ -143,17 +146,18 @@ DecisionTree<FitnessFunction,
                                             typename std::remove_reference<
                                             WeightsType>::type>::value>*)
 {
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
   using TrueWeightsType = typename std::decay<WeightsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::forward<MatType>(data));
+  // Copy or move the labels.  The data itself is not copied; the nodes reorder
+  // the indices of its points instead.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
   TrueWeightsType tmpWeights(std::forward<WeightsType>(weights));
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
+  Train<true>(data, indices, 0, data.n_cols, tmpLabels, numClasses, tmpWeights,
       minimumLeafSize, minimumGainSplit);
 }
 
@@ -362,17 +366,18 @@ void DecisionTree<FitnessFunction,
     throw std::invalid_argument(oss.str());
   }
 
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::forward<MatType>(data));
+  // Copy or move the labels.  The data itself is not copied; the nodes reorder
+  // the indices of its points instead.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      weights, minimumLeafSize, minimumGainSplit);
+  Train<false>(data, indices, 0, data.n_cols, datasetInfo, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit);
 }
 
 //! Train on the given data, assuming all dimensions are numeric.
@@ -404,16 +409,17 @@ void DecisionTree<FitnessFunction,
     throw std::invalid_argument(oss.str());
   }
 
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::forward<MatType>(data));
+  // Copy or move the labels.  The data itself is not copied; the nodes reorder
+  // the indices of its points instead.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, weights,
+  Train<false>(data, indices, 0, data.n_cols, tmpLabels, numClasses, weights,
       minimumLeafSize, minimumGainSplit);
 }
 
@@ -451,17 +457,18 @@ void DecisionTree<FitnessFunction,
     throw std::invalid_argument(oss.str());
   }
 
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
   using TrueWeightsType = typename std::decay<WeightsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::forward<MatType>(data));
+  // Copy or move the labels.  The data itself is not copied; the nodes reorder
+  // the indices of its points instead.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
   TrueWeightsType tmpWeights(std::forward<WeightsType>(weights));
 
   // Pass off work to the Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
+  Train<true>(data, indices, 0, data.n_cols, datasetInfo, tmpLabels, numClasses,
       tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
@@ -498,17 +505,18 @@ void DecisionTree<FitnessFunction,
     throw std::invalid_argument(oss.str());
   }
 
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
   using TrueWeightsType = typename std::decay<WeightsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::forward<MatType>(data));
+  // Copy or move the labels.  The data itself is not copied; the nodes reorder
+  // the indices of its points instead.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
   TrueLabelsType tmpLabels(std::forward<LabelsType>(labels));
   TrueWeightsType tmpWeights(std::forward<WeightsType>(weights));
 
   // Pass off work to the Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
+  Train<true>(data, indices, 0, data.n_cols, tmpLabels, numClasses, tmpWeights,
       minimumLeafSize, minimumGainSplit);
 }
 
@@ -525,7 +533,8 @@ void DecisionTree<FitnessFunction,
                   CategoricalSplitType,
                   DimensionSelectionType,
                   ElemType,
-                  NoRecursion>::Train(MatType& data,
+                  NoRecursion>::Train(const MatType& data,
+                                      arma::uvec& indices,
                                       const size_t begin,
                                       const size_t count,
                                       const data::DatasetInfo& datasetInfo,
@@ -551,14 +560,19 @@ void DecisionTree<FitnessFunction,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
   DimensionSelectionType dimensions(datasetInfo.Dimensionality());
+  arma::Row<typename MatType::elem_type> dimValues(count);
   for (size_t i = dimensions.Begin(); i != dimensions.End();
        i = dimensions.Next())
   {
+    // Gather the values of this dimension for the points of this node.
+    for (size_t j = 0; j < count; ++j)
+      dimValues[j] = data(i, indices[begin + j]);
+
     double dimGain = -DBL_MAX;
     if (datasetInfo.Type(i) == data::Datatype::categorical)
     {
       dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-          data.cols(begin, begin + count - 1).row(i),
+          dimValues,
           datasetInfo.NumMappings(i),
           labels.subvec(begin, begin + count - 1),
           numClasses,
@@ -571,7 +585,7 @@ void DecisionTree<FitnessFunction,
     else if (datasetInfo.Type(i) == data::Datatype::numeric)
     {
       dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-          data.cols(begin, begin + count - 1).row(i),
+          dimValues,
           labels.subvec(begin, begin + count - 1),
           numClasses,
           UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
@@ -612,14 +626,14 @@ void DecisionTree<FitnessFunction,
     {
       for (size_t j = begin; j < begin + count; ++j)
         childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
+            (ElemType) data(bestDim, indices[j]), classProbabilities, *this);
     }
     else
     {
       for (size_t j = begin; j < begin + count; ++j)
       {
         childAssignments[j - begin] = NumericSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
+            (ElemType) data(bestDim, indices[j]), classProbabilities, *this);
       }
     }
 
@@ -638,7 +652,7 @@ void DecisionTree<FitnessFunction,
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
+          std::swap(indices[currentCol], indices[j]);
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
@@ -650,13 +664,13 @@ void DecisionTree<FitnessFunction,
       DecisionTree* child = new DecisionTree();
       if (NoRecursion)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
+        child->Train<UseWeights>(data, indices, currentChildBegin,
             currentCol - currentChildBegin, datasetInfo, labels, numClasses,
             weights, currentCol - currentChildBegin, minimumGainSplit);
       }
       else
       {
-        child->Train<UseWeights>(data, currentChildBegin,
+        child->Train<UseWeights>(data, indices, currentChildBegin,
             currentCol - currentChildBegin, datasetInfo, labels, numClasses,
             weights, minimumLeafSize, minimumGainSplit);
       }
@@ -690,7 +704,8 @@ void DecisionTree<FitnessFunction,
                   CategoricalSplitType,
                   DimensionSelectionType,
                   ElemType,
-                  NoRecursion>::Train(MatType& data,
+                  NoRecursion>::Train(const MatType& data,
+                                      arma::uvec& indices,
                                       const size_t begin,
                                       const size_t count,
                                       arma::Row<size_t>& labels,
@@ -717,11 +732,16 @@ void DecisionTree<FitnessFunction,
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = data.n_rows; // This means "no split".
+  arma::Row<typename MatType::elem_type> dimValues(count);
   for (size_t i = 0; i < data.n_rows; ++i)
   {
+    // Gather the values of this dimension for the points of this node.
+    for (size_t j = 0; j < count; ++j)
+      dimValues[j] = data(i, indices[begin + j]);
+
     const double dimGain = NumericSplitType<FitnessFunction>::template
         SplitIfBetter<UseWeights>(bestGain,
-                                  data.cols(begin, begin + count - 1).row(i),
+                                  dimValues,
                                   labels.cols(begin, begin + count - 1),
                                   numClasses,
                                   UseWeights ?
@@ -757,7 +777,7 @@ void DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
     {
       childAssignments[j - begin] = NumericSplit::CalculateDirection(
-          data(bestDim, j), classProbabilities, *this);
+          (ElemType) data(bestDim, indices[j]), classProbabilities, *this);
     }
 
     // Calculate counts of children in each node.
@@ -775,7 +795,7 @@ void DecisionTree<FitnessFunction,
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
+          std::swap(indices[currentCol], indices[j]);
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
@@ -787,13 +807,13 @@ void DecisionTree<FitnessFunction,
       DecisionTree* child = new DecisionTree();
       if (NoRecursion)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
+        child->Train<UseWeights>(data, indices, currentChildBegin,
             currentCol - currentChildBegin, labels, numClasses, weights,
             currentCol - currentChildBegin, minimumGainSplit);
       }
       else
       {
-        child->Train<UseWeights>(data, currentChildBegin,
+        child->Train<UseWeights>(data, indices, currentChildBegin,
             currentCol - currentChildBegin, labels, numClasses, weights,
             minimumLeafSize, minimumGainSplit);
       }
@@ -981,11 +1001,11 @@ size_t DecisionTree<FitnessFunction,
 {
   if ((data::Datatype) dimensionTypeOrMajorityClass ==
       data::Datatype::categorical)
-    return CategoricalSplit::CalculateDirection(point[splitDimension],
-        classProbabilities, *this);
+    return CategoricalSplit::CalculateDirection(
+        (ElemType) point[splitDimension], classProbabilities, *this);
   else
-    return NumericSplit::CalculateDirection(point[splitDimension],
-        classProbabilities, *this);
+    return NumericSplit::CalculateDirection(
+        (ElemType) point[splitDimension], classProbabilities, *this);
 }
 
 // Get the number of classes in the tree.
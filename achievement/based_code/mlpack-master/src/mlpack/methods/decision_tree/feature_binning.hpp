@@ -0,0 +1,121 @@
+/**
+ * @file feature_binning.hpp
+ *
+ * The FeatureBinning class, which quantizes each dimension of a dataset into
+ * at most 256 bins for histogram-based decision tree training.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FEATURE_BINNING_HPP
+#define MLPACK_METHODS_DECISION_TREE_FEATURE_BINNING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Quantize each dimension of a numeric dataset into at most maxBins (at most
+ * 256) bins, so that a point takes one byte per dimension.  Fit() finds the
+ * cut points of each dimension once: if a dimension has at most maxBins
+ * distinct values, each value gets its own bin; otherwise the cut points are
+ * quantiles of the values, so bins hold about the same number of points.  A
+ * value x falls in bin b if cuts[b - 1] < x <= cuts[b].
+ *
+ * The binned data is meant to be used with HistogramNumericSplit, which finds
+ * splits from per-node bin histograms instead of sorting each dimension at
+ * each node.  Points to classify by a tree trained on binned data must be
+ * binned by the same FeatureBinning.
+ *
+ * @code
+ * extern arma::mat data, testData;
+ * extern arma::Row<size_t> labels;
+ *
+ * FeatureBinning binning;
+ * arma::Mat<unsigned char> binned, binnedTest;
+ * binning.Fit(data);
+ * binning.Transform(data, binned);
+ * binning.Transform(testData, binnedTest);
+ *
+ * DecisionTree<GiniGain, HistogramNumericSplit> tree(binned, labels, 2);
+ * arma::Row<size_t> predictions;
+ * tree.Classify(binnedTest, predictions);
+ * @endcode
+ */
+class FeatureBinning
+{
+ public:
+  /**
+   * Create the binning without fitting it.
+   *
+   * @param maxBins Maximum number of bins of each dimension (at most 256).
+   */
+  FeatureBinning(const size_t maxBins = 256) : maxBins(maxBins)
+  {
+    if (maxBins < 2 || maxBins > 256)
+    {
+      std::ostringstream oss;
+      oss << "FeatureBinning::FeatureBinning(): maxBins must be between 2 and "
+          << "256, but " << maxBins << " was given!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  /**
+   * Find the cut points of each dimension of the given data.  Dimensions are
+   * processed in parallel when mlpack is compiled with OpenMP.
+   *
+   * @param data Dataset, one column per point.
+   */
+  template<typename MatType>
+  void Fit(const MatType& data);
+
+  /**
+   * Quantize the given data with the cut points found by Fit().
+   *
+   * @param data Dataset, one column per point.
+   * @param binned This will be filled with the bin of each value.
+   */
+  template<typename MatType>
+  void Transform(const MatType& data, arma::Mat<unsigned char>& binned) const;
+
+  //! Get the number of bins of the given dimension.
+  size_t NumBins(const size_t dimension) const
+  {
+    return cuts[dimension].n_elem + 1;
+  }
+
+  //! Get the cut points of the given dimension.
+  const arma::vec& Cuts(const size_t dimension) const
+  {
+    return cuts[dimension];
+  }
+
+  //! Get the maximum number of bins of each dimension.
+  size_t MaxBins() const { return maxBins; }
+
+  //! Serialize the binning.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(maxBins);
+    ar & BOOST_SERIALIZATION_NVP(cuts);
+  }
+
+ private:
+  //! Maximum number of bins of each dimension.
+  size_t maxBins;
+  //! The cut points of each dimension; the last bin has no upper cut point.
+  std::vector<arma::vec> cuts;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "feature_binning_impl.hpp"
+
+#endif
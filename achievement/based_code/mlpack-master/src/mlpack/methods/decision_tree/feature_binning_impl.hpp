@@ -0,0 +1,99 @@
+/**
+ * @file feature_binning_impl.hpp
+ *
+ * Implementation of the FeatureBinning class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_FEATURE_BINNING_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_FEATURE_BINNING_IMPL_HPP
+
+// In case it hasn't been included already.
+#include "feature_binning.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+void FeatureBinning::Fit(const MatType& data)
+{
+  cuts.clear();
+  cuts.resize(data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+  {
+    const arma::vec values = arma::sort(arma::conv_to<arma::vec>::from(
+        data.row(d)));
+    if (values.n_elem == 0)
+      continue;
+
+    // Count the distinct values.
+    size_t numDistinct = 1;
+    for (size_t i = 1; i < values.n_elem; ++i)
+      if (values[i] != values[i - 1])
+        ++numDistinct;
+
+    std::vector<double> dimCuts;
+    if (numDistinct <= maxBins)
+    {
+      // One bin per value; cut halfway between consecutive values.
+      for (size_t i = 1; i < values.n_elem; ++i)
+        if (values[i] != values[i - 1])
+          dimCuts.push_back((values[i - 1] + values[i]) / 2.0);
+    }
+    else
+    {
+      // Cut at the quantiles; runs of equal values may merge some bins.
+      for (size_t b = 1; b < maxBins; ++b)
+      {
+        const size_t i = (b * values.n_elem) / maxBins;
+        if (i == 0 || values[i] == values[i - 1])
+          continue;
+
+        const double cut = (values[i - 1] + values[i]) / 2.0;
+        if (dimCuts.empty() || cut > dimCuts.back())
+          dimCuts.push_back(cut);
+      }
+    }
+
+    cuts[d] = arma::vec(dimCuts);
+  }
+}
+
+template<typename MatType>
+void FeatureBinning::Transform(const MatType& data,
+                               arma::Mat<unsigned char>& binned) const
+{
+  if (data.n_rows != cuts.size())
+  {
+    std::ostringstream oss;
+    oss << "FeatureBinning::Transform(): dimensionality of data ("
+        << data.n_rows << ") does not match the binning (" << cuts.size()
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  binned.set_size(data.n_rows, data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+  {
+    for (size_t d = 0; d < data.n_rows; ++d)
+    {
+      // The bin is the number of cut points below the value.
+      const double* begin = cuts[d].memptr();
+      const double* end = begin + cuts[d].n_elem;
+      binned(d, j) = (unsigned char) (std::lower_bound(begin, end,
+          (double) data(d, j)) - begin);
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
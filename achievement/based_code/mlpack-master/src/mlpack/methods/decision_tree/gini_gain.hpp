@@ -175,6 +175,35 @@ class GiniGain
     return -impurity;
   }
 
+  /**
+   * Evaluate the Gini impurity from the (possibly weighted) number of points of
+   * each class, without the labels themselves.  This is what split strategies
+   * that sweep class counts through a sorted dimension use, so that each
+   * candidate split costs O(numClasses) instead of O(n).
+   *
+   * @param counts Number (or total weight) of points of each class.
+   * @param numClasses Number of classes in the dataset.
+   * @param totalCount Total number (or weight) of points; the sum of counts.
+   */
+  template<typename CountType>
+  static double EvaluatePtr(const CountType* counts,
+                            const size_t numClasses,
+                            const CountType totalCount)
+  {
+    // Corner case: if there are no elements, the impurity is zero.
+    if (totalCount == 0)
+      return 0.0;
+
+    double impurity = 0.0;
+    for (size_t i = 0; i < numClasses; ++i)
+    {
+      const double f = ((double) counts[i] / (double) totalCount);
+      impurity += f * (1.0 - f);
+    }
+
+    return -impurity;
+  }
+
   /**
    * Return the range of the Gini impurity for the given number of classes.
    * (That is, the difference between the maximum possible value and the minimum
@@ -0,0 +1,116 @@
+/**
+ * @file histogram_numeric_split.hpp
+ *
+ * A tree splitting strategy that finds the best binary split of a binned
+ * numeric dimension from a histogram of its bins.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HistogramNumericSplit is a splitting function for decision trees that
+ * searches a binned numeric dimension (values are bins between 0 and 255, such
+ * as those given by FeatureBinning) for the best binary split.  Instead of
+ * sorting the dimension, one pass over the points of the node fills the class
+ * counts (or class weight sums) of each bin, and the splits between bins are
+ * then scanned with the counts of the left child accumulated bin by bin and
+ * those of the right child obtained by subtracting them from the node's
+ * counts.  A split thus costs O(n + 256 * numClasses) instead of O(n log n).
+ *
+ * Like BestBinaryNumericSplit, it requires FitnessFunction to provide
+ * EvaluatePtr().  The data may be arma::Mat<unsigned char> or any matrix of
+ * bin indices; trees trained on binned data must classify binned points.
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class HistogramNumericSplit
+{
+ public:
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  //! The number of bins of a dimension.
+  static const size_t MaxBins = 256;
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then classProbabilities
+   * holds the split point, halfway between two bins.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The bins of the dimension of data points to check for a split
+   *      in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of each point.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux (Unused) auxiliary split information.
+   */
+  template<bool UseWeights,
+           typename VecType,
+           typename WeightVecType,
+           typename ElemType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<ElemType>& classProbabilities,
+      AuxiliarySplitInfo<ElemType>& aux);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given the bin of a point, calculate which child it should go to (left or
+   * right).
+   *
+   * @param point Bin of the point to calculate direction of.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param aux (Unused) auxiliary information for the split.
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return (point <= classProbabilities[0]) ? 0 : 1;
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_numeric_split_impl.hpp"
+
+#endif
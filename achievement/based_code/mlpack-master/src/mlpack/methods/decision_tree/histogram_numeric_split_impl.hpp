@@ -0,0 +1,121 @@
+/**
+ * @file histogram_numeric_split_impl.hpp
+ *
+ * Implementation of the split of a binned numeric dimension from a histogram
+ * of its bins.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included already.
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights,
+         typename VecType,
+         typename WeightVecType,
+         typename ElemType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<ElemType>& classProbabilities,
+    AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return bestGain;
+
+  // Fill the histogram: the class counts (or class weight sums) of each bin,
+  // one column per bin, and the number of points of each bin.
+  arma::mat histogram(numClasses, MaxBins, arma::fill::zeros);
+  arma::Col<size_t> binCounts(MaxBins, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t bin = (size_t) data[i];
+    if (bin >= MaxBins)
+    {
+      std::ostringstream oss;
+      oss << "HistogramNumericSplit::SplitIfBetter(): bin " << bin << " is "
+          << "out of range; the data must be binned into at most " << MaxBins
+          << " bins!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    histogram(labels[i], bin) += UseWeights ? (double) weights[i] : 1.0;
+    ++binCounts[bin];
+  }
+
+  const arma::vec totalCounts = arma::sum(histogram, 1);
+  const double totalWeight = arma::accu(totalCounts);
+  if (totalWeight == 0.0)
+    return bestGain;
+
+  // Scan the splits between bins; the right child's counts are the node's
+  // counts minus the left child's.
+  double bestFoundGain = bestGain;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  arma::vec rightCounts(numClasses);
+  double leftWeight = 0.0;
+  size_t leftPoints = 0;
+  for (size_t bin = 0; bin < MaxBins - 1; ++bin)
+  {
+    // Splitting after an empty bin is the same as splitting before it.
+    if (binCounts[bin] == 0)
+      continue;
+
+    leftCounts += histogram.col(bin);
+    leftPoints += binCounts[bin];
+    leftWeight = arma::accu(leftCounts);
+    if (leftPoints < minimum)
+      continue;
+    if (data.n_elem - leftPoints < minimum)
+      break;
+
+    rightCounts = totalCounts - leftCounts;
+    const double rightWeight = std::max(totalWeight - leftWeight, 0.0);
+    const double leftGain = FitnessFunction::EvaluatePtr(leftCounts.memptr(),
+        numClasses, leftWeight);
+    const double rightGain = FitnessFunction::EvaluatePtr(
+        rightCounts.memptr(), numClasses, rightWeight);
+    const double gain = (leftWeight / totalWeight) * leftGain +
+        (rightWeight / totalWeight) * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = bin + 0.5;
+      return gain;
+    }
+    else if (gain > bestFoundGain + minimumGainSplit)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = bin + 0.5;
+    }
+  }
+
+  return bestFoundGain;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
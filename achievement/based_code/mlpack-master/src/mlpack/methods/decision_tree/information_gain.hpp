@@ -172,6 +172,36 @@ class InformationGain
     return gain;
   }
 
+  /**
+   * Evaluate the information gain from the (possibly weighted) number of
+   * points of each class, without the labels themselves.  This is what split
+   * strategies that sweep class counts through a sorted dimension use, so that
+   * each candidate split costs O(numClasses) instead of O(n).
+   *
+   * @param counts Number (or total weight) of points of each class.
+   * @param numClasses Number of classes in the dataset.
+   * @param totalCount Total number (or weight) of points; the sum of counts.
+   */
+  template<typename CountType>
+  static double EvaluatePtr(const CountType* counts,
+                            const size_t numClasses,
+                            const CountType totalCount)
+  {
+    // Edge case: if there are no elements, the gain is zero.
+    if (totalCount == 0)
+      return 0.0;
+
+    double gain = 0.0;
+    for (size_t i = 0; i < numClasses; ++i)
+    {
+      const double f = ((double) counts[i] / (double) totalCount);
+      if (f > 0.0)
+        gain += f * std::log2(f);
+    }
+
+    return gain;
+  }
+
   /**
    * Return the range of the information gain for the given number of classes.
    * (That is, the difference between the maximum possible value and the minimum
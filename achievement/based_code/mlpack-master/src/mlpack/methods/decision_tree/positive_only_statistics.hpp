@@ -0,0 +1,92 @@
+/**
+ * @file positive_only_statistics.hpp
+ *
+ * The PositiveOnlyStatistics class, which estimates the class counts of a
+ * node of a C45Tree from positive and unlabeled points, as in POSC4.5.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_POSITIVE_ONLY_STATISTICS_HPP
+#define MLPACK_METHODS_DECISION_TREE_POSITIVE_ONLY_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The statistics of POSC4.5 (Denis et al., 2005), which learns a C4.5 tree
+ * from positive and unlabeled points and the prior probability p of the
+ * positive class.  Label 1 marks the positive points and label 0 the
+ * unlabeled points.  The positives of a node are a sample of the positives
+ * among its unlabeled points, so a node with POS_n positive and UNL_n
+ * unlabeled points is estimated to hold
+ *
+ * POS_n / |POS| * p * |UNL|
+ *
+ * positives, and the rest of UNL_n, if any, negatives.  The class
+ * probabilities are those of POSC4.5, which clips the positives to UNL_n; not
+ * clipping them keeps a node of positive points only a positive node.  See
+ * ClassStatistics for the interface.
+ */
+class PositiveOnlyStatistics
+{
+ public:
+  /**
+   * Create the statistics with the given prior probability of the positive
+   * class.
+   *
+   * @param positivePrior Fraction of positives among the unlabeled points.
+   */
+  PositiveOnlyStatistics(const double positivePrior = 0.5) :
+      positivePrior(positivePrior),
+      scale(0.0)
+  {
+    if (positivePrior <= 0.0 || positivePrior >= 1.0)
+    {
+      std::ostringstream oss;
+      oss << "PositiveOnlyStatistics::PositiveOnlyStatistics(): the positive "
+          << "prior must be in (0, 1), but " << positivePrior << " was given!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  //! Compute the weight of a positive point from the totals of both labels.
+  void Initialize(const arma::vec& labelCounts)
+  {
+    if (labelCounts.n_elem != 2 || labelCounts[0] == 0.0 ||
+        labelCounts[1] == 0.0)
+    {
+      throw std::invalid_argument("PositiveOnlyStatistics::Initialize(): "
+          "there must be both positive (label 1) and unlabeled (label 0) "
+          "points, and no other labels!");
+    }
+
+    scale = positivePrior * labelCounts[0] / labelCounts[1];
+  }
+
+  //! Estimate the number of negatives and positives of a node.
+  void ClassCounts(const arma::vec& labelCounts, arma::vec& classCounts) const
+  {
+    classCounts.set_size(2);
+    classCounts[1] = scale * labelCounts[1];
+    classCounts[0] = std::max(labelCounts[0] - classCounts[1], 0.0);
+  }
+
+  //! Get the prior probability of the positive class.
+  double PositivePrior() const { return positivePrior; }
+
+ private:
+  //! Prior probability of the positive class.
+  double positivePrior;
+  //! Estimated number of unlabeled positives per positive point.
+  double scale;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
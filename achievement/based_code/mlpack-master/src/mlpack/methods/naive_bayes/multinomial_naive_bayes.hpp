@@ -0,0 +1,253 @@
+/**
+ * @file multinomial_naive_bayes.hpp
+ *
+ * A multinomial Naive Bayes classifier for sparse count data such as term
+ * frequencies of text documents.  Unlike NaiveBayesClassifier, the model never
+ * densifies the data: training is one pass over the nonzero elements and
+ * classification is a sparse-dense product with the log-probability matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NAIVE_BAYES_MULTINOMIAL_NAIVE_BAYES_HPP
+#define MLPACK_METHODS_NAIVE_BAYES_MULTINOMIAL_NAIVE_BAYES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace naive_bayes {
+
+/**
+ * The multinomial Naive Bayes classifier.  Each point is a vector of
+ * nonnegative counts (for instance, the number of occurrences of each term in a
+ * document), and each class y has a distribution P(X = i | Y = y) over the
+ * features, estimated with additive (Laplace) smoothing:
+ *
+ * P(X = i | Y = y) = (n_iy + alpha) / (n_y + alpha * d),
+ *
+ * where n_iy is the total count of feature i over the points of class y, n_y
+ * the total count of all features in class y, and d the dimensionality.  A
+ * point x is then classified as
+ *
+ * arg max_y (log P(Y = y) + sum_i x_i log P(X = i | Y = y)).
+ *
+ * Training and classification go over the nonzero elements of the data only.
+ * Data given as an arma::SpMat is used in place; any other matrix type is
+ * converted to one first.  When mlpack is compiled with OpenMP, the counts are
+ * accumulated by each thread into a private d x k matrix and summed at the end,
+ * and points are classified in parallel.
+ *
+ * @code
+ * extern arma::sp_mat documents; // One column per document.
+ * extern arma::Row<size_t> labels;
+ * MultinomialNaiveBayes<> nb(documents, labels, 2);
+ *
+ * extern arma::sp_mat testDocuments;
+ * arma::Row<size_t> predictions;
+ * nb.Classify(testDocuments, predictions);
+ * @endcode
+ *
+ * @tparam ModelMatType Internal matrix type to use to store the model.
+ */
+template<typename ModelMatType = arma::mat>
+class MultinomialNaiveBayes
+{
+ public:
+  // Convenience typedef.
+  typedef typename ModelMatType::elem_type ElemType;
+
+  /**
+   * Train the classifier on the given data.
+   *
+   * @param data Training data points, one column per point.
+   * @param labels Labels corresponding to training data points.
+   * @param numClasses Number of classes in this classifier.
+   * @param alpha Additive smoothing parameter.
+   */
+  template<typename MatType>
+  MultinomialNaiveBayes(const MatType& data,
+                        const arma::Row<size_t>& labels,
+                        const size_t numClasses,
+                        const double alpha = 1.0);
+
+  /**
+   * Initialize the classifier without performing training.  All feature
+   * probabilities are uniform and all classes are equally likely.
+   *
+   * @param dimensionality Dimensionality of the data.
+   * @param numClasses Number of classes in this classifier.
+   * @param alpha Additive smoothing parameter.
+   */
+  MultinomialNaiveBayes(const size_t dimensionality = 0,
+                        const size_t numClasses = 0,
+                        const double alpha = 1.0);
+
+  /**
+   * Train the classifier on the given data.  The current model is replaced.
+   *
+   * @param data Training data points, one column per point.
+   * @param labels Labels corresponding to training data points.
+   * @param numClasses Number of classes in this classifier.
+   */
+  template<typename MatType>
+  void Train(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses);
+
+  /**
+   * Train the classifier on points with fractional class memberships.  Point
+   * j counts as responsibilities(c, j) points of class c; the columns of
+   * responsibilities usually sum to one.  The current model is replaced.
+   *
+   * @param data Training data points, one column per point.
+   * @param responsibilities Class memberships (k x n).
+   * @throws std::invalid_argument if responsibilities does not have one
+   *     column per point.
+   */
+  template<typename MatType>
+  void Train(const MatType& data, const ModelMatType& responsibilities);
+
+  /**
+   * Refine the model by expectation-maximization over labeled and unlabeled
+   * points (Nigam et al., 2000), as in the NB-EM and S-EM methods for learning
+   * from positive and unlabeled data.  Starting from the current model, each
+   * iteration computes the posterior of every unlabeled point and trains on
+   * the labeled points plus the unlabeled points weighted by their posteriors.
+   * Both steps are one parallel pass over the unlabeled nonzeros: the weighted
+   * counts of each point are accumulated as soon as its posterior is known, so
+   * no responsibility matrix is stored.  Iteration stops when the relative
+   * change of the log-likelihood is at most tolerance, or after maxIterations
+   * iterations.
+   *
+   * The model must already have the dimensionality and number of classes of
+   * the data; for S-EM, for instance, train it first with the unlabeled points
+   * as negatives.
+   *
+   * @param labeledData Labeled points, one column per point.
+   * @param labels Labels of the labeled points.
+   * @param unlabeledData Unlabeled points, one column per point.
+   * @param maxIterations Maximum number of iterations (0 for no limit).
+   * @param tolerance Relative change of the log-likelihood to stop at.
+   * @return The log-likelihood of the data under the final model, up to the
+   *     multinomial coefficients.
+   */
+  template<typename LabeledMatType, typename UnlabeledMatType>
+  double EM(const LabeledMatType& labeledData,
+            const arma::Row<size_t>& labels,
+            const UnlabeledMatType& unlabeledData,
+            const size_t maxIterations = 100,
+            const double tolerance = 1e-6);
+
+  /**
+   * Classify the given point and return the predicted label.
+   *
+   * @param point Point to classify.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points and also return the posterior probability of
+   * each class for each point.
+   *
+   * @param data Set of points to classify.
+   * @param predictions This will be filled with predictions for each point.
+   * @param probabilities This will be filled with class probabilities; each
+   *     column corresponds to a point.
+   */
+  template<typename MatType, typename ProbabilitiesMatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                ProbabilitiesMatType& probabilities) const;
+
+  //! Get the total count of each feature in each class (d x k).
+  const ModelMatType& Counts() const { return counts; }
+  //! Get the number of training points in each class.
+  const ModelMatType& ClassCounts() const { return classCounts; }
+
+  //! Get log P(X = i | Y = y); column i holds the log probabilities of
+  //! feature i for all classes (k x d).
+  const ModelMatType& LogProbabilities() const { return logProbabilities; }
+  //! Get the log prior probability of each class.
+  const ModelMatType& LogPriors() const { return logPriors; }
+
+  //! Get the smoothing parameter.
+  double Alpha() const { return alpha; }
+  //! Modify the smoothing parameter.  The model is recomputed from the counts.
+  void Alpha(const double newAlpha) { alpha = newAlpha; UpdateModel(); }
+
+  //! Serialize the classifier.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Total count of each feature in each class.
+  ModelMatType counts;
+  //! Number of training points in each class; a column vector.
+  ModelMatType classCounts;
+  //! Log probability of each feature in each class, transposed so that the
+  //! values of one feature are contiguous.
+  ModelMatType logProbabilities;
+  //! Log prior probability of each class; a column vector.
+  ModelMatType logPriors;
+  //! Additive smoothing parameter.
+  double alpha;
+
+  //! Compute logProbabilities and logPriors from the counts.
+  void UpdateModel();
+
+  //! Add the counts of the labeled points x to newCounts and newClassCounts.
+  static void Accumulate(const arma::SpMat<ElemType>& x,
+                         const arma::Row<size_t>& labels,
+                         ModelMatType& newCounts,
+                         ModelMatType& newClassCounts);
+
+  //! Return the log-likelihood of the labeled points x.
+  double LabeledLogLikelihood(const arma::SpMat<ElemType>& x,
+                              const arma::Row<size_t>& labels) const;
+
+  //! Add the counts of the unlabeled points x, weighted by their posteriors
+  //! under the current model, to newCounts and newClassCounts, and return their
+  //! log-likelihood.
+  double Expectation(const arma::SpMat<ElemType>& x,
+                     ModelMatType& newCounts,
+                     ModelMatType& newClassCounts) const;
+
+  //! Return the data as a sparse matrix, converting it into copy if needed.
+  static const arma::SpMat<ElemType>& SparseData(
+      const arma::SpMat<ElemType>& data,
+      arma::SpMat<ElemType>& /* copy */) { return data; }
+  template<typename MatType>
+  static const arma::SpMat<ElemType>& SparseData(
+      const MatType& data,
+      arma::SpMat<ElemType>& copy);
+
+  /**
+   * Compute the unnormalized log posterior of each class for each point; each
+   * column of logLikelihoods corresponds to a point.
+   *
+   * @param data Set of points to compute log likelihoods for.
+   * @param logLikelihoods Matrix to store log likelihoods in.
+   */
+  template<typename MatType>
+  void LogLikelihood(const MatType& data, ModelMatType& logLikelihoods) const;
+};
+
+} // namespace naive_bayes
+} // namespace mlpack
+
+// Include implementation.
+#include "multinomial_naive_bayes_impl.hpp"
+
+#endif
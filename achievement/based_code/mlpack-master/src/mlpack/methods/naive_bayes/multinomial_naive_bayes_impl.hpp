@@ -0,0 +1,420 @@
+/**
+ * @file multinomial_naive_bayes_impl.hpp
+ *
+ * Implementation of the multinomial Naive Bayes classifier.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NAIVE_BAYES_MULTINOMIAL_NAIVE_BAYES_IMPL_HPP
+#define MLPACK_METHODS_NAIVE_BAYES_MULTINOMIAL_NAIVE_BAYES_IMPL_HPP
+
+#include <mlpack/prereqs.hpp>
+
+// In case it hasn't been included already.
+#include "multinomial_naive_bayes.hpp"
+
+namespace mlpack {
+namespace naive_bayes {
+
+template<typename ModelMatType>
+template<typename MatType>
+MultinomialNaiveBayes<ModelMatType>::MultinomialNaiveBayes(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const double alpha) :
+    alpha(alpha)
+{
+  Train(data, labels, numClasses);
+}
+
+template<typename ModelMatType>
+MultinomialNaiveBayes<ModelMatType>::MultinomialNaiveBayes(
+    const size_t dimensionality,
+    const size_t numClasses,
+    const double alpha) :
+    alpha(alpha)
+{
+  counts.zeros(dimensionality, numClasses);
+  classCounts.zeros(numClasses, 1);
+  UpdateModel();
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+const arma::SpMat<typename ModelMatType::elem_type>&
+MultinomialNaiveBayes<ModelMatType>::SparseData(
+    const MatType& data,
+    arma::SpMat<ElemType>& copy)
+{
+  copy = arma::SpMat<ElemType>(data);
+  return copy;
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void MultinomialNaiveBayes<ModelMatType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses)
+{
+  static_assert(std::is_same<ElemType, typename MatType::elem_type>::value,
+      "MultinomialNaiveBayes: element type of given data must match the "
+      "element type of the model!");
+
+  arma::SpMat<ElemType> copy;
+  const arma::SpMat<ElemType>& x = SparseData(data, copy);
+
+  counts.zeros(x.n_rows, numClasses);
+  classCounts.zeros(numClasses, 1);
+  Accumulate(x, labels, counts, classCounts);
+  UpdateModel();
+}
+
+template<typename ModelMatType>
+void MultinomialNaiveBayes<ModelMatType>::Accumulate(
+    const arma::SpMat<ElemType>& x,
+    const arma::Row<size_t>& labels,
+    ModelMatType& newCounts,
+    ModelMatType& newClassCounts)
+{
+  for (size_t j = 0; j < x.n_cols; ++j)
+    ++newClassCounts[labels[j]];
+
+  // One pass over the nonzero elements.  Each thread sums into its own
+  // matrix, so no synchronization is needed until the end.
+  #pragma omp parallel
+  {
+    ModelMatType localCounts(newCounts.n_rows, newCounts.n_cols,
+        arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t j = 0; j < (omp_size_t) x.n_cols; ++j)
+    {
+      ElemType* c = localCounts.colptr(labels[j]);
+      typename arma::SpMat<ElemType>::const_iterator it = x.begin_col(j);
+      for (; it != x.end_col(j); ++it)
+        c[it.row()] += (*it);
+    }
+
+    #pragma omp critical
+    {
+      newCounts += localCounts;
+    }
+  }
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void MultinomialNaiveBayes<ModelMatType>::Train(
+    const MatType& data,
+    const ModelMatType& responsibilities)
+{
+  static_assert(std::is_same<ElemType, typename MatType::elem_type>::value,
+      "MultinomialNaiveBayes: element type of given data must match the "
+      "element type of the model!");
+
+  if (responsibilities.n_cols != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "MultinomialNaiveBayes::Train(): number of responsibilities ("
+        << responsibilities.n_cols << ") does not match the number of points ("
+        << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::SpMat<ElemType> copy;
+  const arma::SpMat<ElemType>& x = SparseData(data, copy);
+  const size_t numClasses = responsibilities.n_rows;
+
+  counts.zeros(x.n_rows, numClasses);
+  classCounts = arma::sum(responsibilities, 1);
+
+  #pragma omp parallel
+  {
+    ModelMatType localCounts(x.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t j = 0; j < (omp_size_t) x.n_cols; ++j)
+    {
+      const ElemType* r = responsibilities.colptr(j);
+      typename arma::SpMat<ElemType>::const_iterator it = x.begin_col(j);
+      for (; it != x.end_col(j); ++it)
+        for (size_t c = 0; c < numClasses; ++c)
+          localCounts(it.row(), c) += r[c] * (*it);
+    }
+
+    #pragma omp critical
+    {
+      counts += localCounts;
+    }
+  }
+
+  UpdateModel();
+}
+
+template<typename ModelMatType>
+double MultinomialNaiveBayes<ModelMatType>::LabeledLogLikelihood(
+    const arma::SpMat<ElemType>& x,
+    const arma::Row<size_t>& labels) const
+{
+  double logLikelihood = 0;
+  #pragma omp parallel for reduction(+:logLikelihood)
+  for (omp_size_t j = 0; j < (omp_size_t) x.n_cols; ++j)
+  {
+    const size_t label = labels[j];
+    double l = logPriors[label];
+    typename arma::SpMat<ElemType>::const_iterator it = x.begin_col(j);
+    for (; it != x.end_col(j); ++it)
+      l += (*it) * logProbabilities(label, it.row());
+    logLikelihood += l;
+  }
+  return logLikelihood;
+}
+
+template<typename ModelMatType>
+double MultinomialNaiveBayes<ModelMatType>::Expectation(
+    const arma::SpMat<ElemType>& x,
+    ModelMatType& newCounts,
+    ModelMatType& newClassCounts) const
+{
+  const size_t numClasses = logPriors.n_elem;
+  double logLikelihood = 0;
+
+  #pragma omp parallel reduction(+:logLikelihood)
+  {
+    ModelMatType localCounts(newCounts.n_rows, numClasses, arma::fill::zeros);
+    ModelMatType localClassCounts(numClasses, 1, arma::fill::zeros);
+    arma::Col<ElemType> posterior(numClasses);
+
+    #pragma omp for
+    for (omp_size_t j = 0; j < (omp_size_t) x.n_cols; ++j)
+    {
+      // E step for this point: its posterior under the current model.
+      for (size_t c = 0; c < numClasses; ++c)
+        posterior[c] = logPriors[c];
+      typename arma::SpMat<ElemType>::const_iterator it = x.begin_col(j);
+      for (; it != x.end_col(j); ++it)
+      {
+        const ElemType* p = logProbabilities.colptr(it.row());
+        for (size_t c = 0; c < numClasses; ++c)
+          posterior[c] += (*it) * p[c];
+      }
+      const ElemType maxLogLikelihood = posterior.max();
+      posterior = arma::exp(posterior - maxLogLikelihood);
+      const ElemType sum = arma::accu(posterior);
+      posterior /= sum;
+      logLikelihood += maxLogLikelihood + std::log(sum);
+
+      // Its share of the M step.
+      localClassCounts += posterior;
+      for (it = x.begin_col(j); it != x.end_col(j); ++it)
+        for (size_t c = 0; c < numClasses; ++c)
+          localCounts(it.row(), c) += posterior[c] * (*it);
+    }
+
+    #pragma omp critical
+    {
+      newCounts += localCounts;
+      newClassCounts += localClassCounts;
+    }
+  }
+
+  return logLikelihood;
+}
+
+template<typename ModelMatType>
+template<typename LabeledMatType, typename UnlabeledMatType>
+double MultinomialNaiveBayes<ModelMatType>::EM(
+    const LabeledMatType& labeledData,
+    const arma::Row<size_t>& labels,
+    const UnlabeledMatType& unlabeledData,
+    const size_t maxIterations,
+    const double tolerance)
+{
+  static_assert(std::is_same<ElemType,
+                             typename LabeledMatType::elem_type>::value,
+      "MultinomialNaiveBayes: element type of given data must match the "
+      "element type of the model!");
+  static_assert(std::is_same<ElemType,
+                             typename UnlabeledMatType::elem_type>::value,
+      "MultinomialNaiveBayes: element type of given data must match the "
+      "element type of the model!");
+
+  arma::SpMat<ElemType> labeledCopy, unlabeledCopy;
+  const arma::SpMat<ElemType>& xl = SparseData(labeledData, labeledCopy);
+  const arma::SpMat<ElemType>& xu = SparseData(unlabeledData, unlabeledCopy);
+
+  if (xl.n_rows != counts.n_rows || xu.n_rows != counts.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "MultinomialNaiveBayes::EM(): dimensionality of data ("
+        << xl.n_rows << ", " << xu.n_rows << ") does not match the model ("
+        << counts.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The counts of the labeled points do not change.
+  ModelMatType labeledCounts(counts.n_rows, counts.n_cols, arma::fill::zeros);
+  ModelMatType labeledClassCounts(counts.n_cols, 1, arma::fill::zeros);
+  Accumulate(xl, labels, labeledCounts, labeledClassCounts);
+
+  double logLikelihood = -std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i != maxIterations; ++i)
+  {
+    ModelMatType newCounts = labeledCounts;
+    ModelMatType newClassCounts = labeledClassCounts;
+    const double newLogLikelihood = LabeledLogLikelihood(xl, labels) +
+        Expectation(xu, newCounts, newClassCounts);
+
+    counts = std::move(newCounts);
+    classCounts = std::move(newClassCounts);
+    UpdateModel();
+
+    Log::Info << "MultinomialNaiveBayes::EM(): iteration " << i
+        << ", log-likelihood " << newLogLikelihood << "." << std::endl;
+    const double change = newLogLikelihood - logLikelihood;
+    logLikelihood = newLogLikelihood;
+    if (std::abs(change) <= tolerance * std::abs(logLikelihood))
+      break;
+  }
+
+  return logLikelihood;
+}
+
+template<typename ModelMatType>
+void MultinomialNaiveBayes<ModelMatType>::UpdateModel()
+{
+  const size_t numClasses = counts.n_cols;
+  logProbabilities.set_size(numClasses, counts.n_rows);
+  logPriors.set_size(numClasses, 1);
+
+  const ElemType total = arma::accu(classCounts);
+  for (size_t c = 0; c < numClasses; ++c)
+  {
+    const ElemType logTotal = std::log(arma::accu(counts.col(c)) +
+        alpha * counts.n_rows);
+    for (size_t i = 0; i < counts.n_rows; ++i)
+      logProbabilities(c, i) = std::log(counts(i, c) + alpha) - logTotal;
+
+    // Without training data, all classes are equally likely.
+    logPriors[c] = (total > 0) ? std::log(classCounts[c] / total) :
+        -std::log((ElemType) numClasses);
+  }
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void MultinomialNaiveBayes<ModelMatType>::LogLikelihood(
+    const MatType& data,
+    ModelMatType& logLikelihoods) const
+{
+  static_assert(std::is_same<ElemType, typename MatType::elem_type>::value,
+      "MultinomialNaiveBayes: element type of given data must match the "
+      "element type of the model!");
+
+  arma::SpMat<ElemType> copy;
+  const arma::SpMat<ElemType>& x = SparseData(data, copy);
+  const size_t numClasses = logPriors.n_elem;
+
+  // logLikelihoods = logPriors + logProbabilities * x, one column at a time.
+  logLikelihoods.set_size(numClasses, x.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) x.n_cols; ++j)
+  {
+    ElemType* l = logLikelihoods.colptr(j);
+    for (size_t c = 0; c < numClasses; ++c)
+      l[c] = logPriors[c];
+
+    typename arma::SpMat<ElemType>::const_iterator it = x.begin_col(j);
+    for (; it != x.end_col(j); ++it)
+    {
+      const ElemType* p = logProbabilities.colptr(it.row());
+      for (size_t c = 0; c < numClasses; ++c)
+        l[c] += (*it) * p[c];
+    }
+  }
+}
+
+template<typename ModelMatType>
+template<typename VecType>
+size_t MultinomialNaiveBayes<ModelMatType>::Classify(
+    const VecType& point) const
+{
+  ModelMatType logLikelihoods;
+  LogLikelihood(point, logLikelihoods);
+
+  arma::uword maxIndex = 0;
+  logLikelihoods.max(maxIndex);
+  return maxIndex;
+}
+
+template<typename ModelMatType>
+template<typename MatType>
+void MultinomialNaiveBayes<ModelMatType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions) const
+{
+  ModelMatType logLikelihoods;
+  LogLikelihood(data, logLikelihoods);
+
+  predictions.set_size(logLikelihoods.n_cols);
+  for (size_t i = 0; i < logLikelihoods.n_cols; ++i)
+  {
+    arma::uword maxIndex = 0;
+    logLikelihoods.unsafe_col(i).max(maxIndex);
+    predictions[i] = maxIndex;
+  }
+}
+
+template<typename ModelMatType>
+template<typename MatType, typename ProbabilitiesMatType>
+void MultinomialNaiveBayes<ModelMatType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    ProbabilitiesMatType& probabilities) const
+{
+  static_assert(std::is_same<ElemType,
+                             typename ProbabilitiesMatType::elem_type>::value,
+      "MultinomialNaiveBayes: element type of given data must match the "
+      "element type of the model!");
+
+  ModelMatType logLikelihoods;
+  LogLikelihood(data, logLikelihoods);
+
+  predictions.set_size(logLikelihoods.n_cols);
+  probabilities.set_size(logLikelihoods.n_rows, logLikelihoods.n_cols);
+  for (size_t i = 0; i < logLikelihoods.n_cols; ++i)
+  {
+    // The log likelihoods of long documents are far below the smallest
+    // double, so they are shifted by their maximum before exp().
+    arma::uword maxIndex = 0;
+    const ElemType maxLogLikelihood =
+        logLikelihoods.unsafe_col(i).max(maxIndex);
+    predictions[i] = maxIndex;
+
+    probabilities.col(i) = arma::exp(logLikelihoods.col(i) - maxLogLikelihood);
+    probabilities.col(i) /= arma::accu(probabilities.col(i));
+  }
+}
+
+template<typename ModelMatType>
+template<typename Archive>
+void MultinomialNaiveBayes<ModelMatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(counts);
+  ar & BOOST_SERIALIZATION_NVP(classCounts);
+  ar & BOOST_SERIALIZATION_NVP(logProbabilities);
+  ar & BOOST_SERIALIZATION_NVP(logPriors);
+  ar & BOOST_SERIALIZATION_NVP(alpha);
+}
+
+} // namespace naive_bayes
+} // namespace mlpack
+
+#endif
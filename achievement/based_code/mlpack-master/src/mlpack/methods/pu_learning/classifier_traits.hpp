@@ -0,0 +1,57 @@
+/**
+ * @file classifier_traits.hpp
+ *
+ * Traits of the classifiers used by the reliable-negative stages of PU
+ * learning.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PU_LEARNING_CLASSIFIER_TRAITS_HPP
+#define MLPACK_METHODS_PU_LEARNING_CLASSIFIER_TRAITS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/naive_bayes/naive_bayes_classifier.hpp>
+#include <mlpack/methods/naive_bayes/multinomial_naive_bayes.hpp>
+
+namespace mlpack {
+namespace pu {
+
+/**
+ * Template class for classifier traits.  This stores the default values for a
+ * classifier; a classifier with different values needs a template
+ * specialization, as the Naive Bayes classifiers below.
+ */
+template<typename ClassifierType>
+struct ClassifierTraits
+{
+  /**
+   * If true, training the classifier does not draw from the random number
+   * generator of mlpack, which is not thread-safe, so several classifiers may
+   * be trained in parallel.
+   */
+  static const bool DeterministicTraining = false;
+};
+
+//! Classifier traits of the Gaussian Naive Bayes classifier.
+template<typename ModelMatType>
+struct ClassifierTraits<naive_bayes::NaiveBayesClassifier<ModelMatType>>
+{
+  //! Training only counts and averages.
+  static const bool DeterministicTraining = true;
+};
+
+//! Classifier traits of the multinomial Naive Bayes classifier.
+template<typename ModelMatType>
+struct ClassifierTraits<naive_bayes::MultinomialNaiveBayes<ModelMatType>>
+{
+  //! Training only counts.
+  static const bool DeterministicTraining = true;
+};
+
+} // namespace pu
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * @file document_frequencies.hpp
+ *
+ * Count the documents in which each term occurs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PU_LEARNING_DOCUMENT_FREQUENCIES_HPP
+#define MLPACK_METHODS_PU_LEARNING_DOCUMENT_FREQUENCIES_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pu {
+
+/**
+ * Add to df the number of documents (columns) of the sparse matrix data in
+ * which each term (row) has a nonzero value.  This is one pass over the
+ * nonzero elements; when mlpack is compiled with OpenMP, each thread counts
+ * into its own vector and the vectors are summed at the end.
+ *
+ * @param data Documents, one column per document.
+ * @param df Document frequencies, with one element per row of data.
+ */
+template<typename MatType>
+void DocumentFrequencies(const MatType& data, arma::Col<size_t>& df)
+{
+  #pragma omp parallel
+  {
+    arma::Col<size_t> localDf(df.n_elem, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      typename MatType::const_iterator it = data.begin_col(j);
+      for (; it != data.end_col(j); ++it)
+        if ((*it) != 0)
+          ++localDf[it.row()];
+    }
+
+    #pragma omp critical
+    {
+      df += localDf;
+    }
+  }
+}
+
+} // namespace pu
+} // namespace mlpack
+
+#endif
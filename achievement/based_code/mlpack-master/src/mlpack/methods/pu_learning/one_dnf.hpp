@@ -0,0 +1,105 @@
+/**
+ * @file one_dnf.hpp
+ *
+ * The 1-DNF technique, which extracts reliable negatives from unlabeled
+ * documents by the features that are more frequent among positives.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PU_LEARNING_ONE_DNF_HPP
+#define MLPACK_METHODS_PU_LEARNING_ONE_DNF_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pu {
+
+/**
+ * The 1-DNF technique of PEBL (Yu et al., 2002).  A feature is positive if the
+ * fraction of positive documents that contain it is higher than the fraction
+ * of unlabeled documents that contain it, and the unlabeled documents that
+ * contain no positive feature are the reliable negatives.  OneDNF is a
+ * reliable-negative stage; see Spy for the interface.
+ *
+ * The document frequencies of P and U are counted by one pass each over the
+ * nonzero elements (see DocumentFrequencies()), and the positive features are
+ * kept as a bitset.  Each unlabeled document is then tested in parallel
+ * against the bitset, stopping at its first positive feature, so the cost is
+ * linear in the number of nonzero elements.
+ *
+ * @code
+ * extern arma::sp_mat positive, unlabeled; // Term frequencies.
+ * OneDNF<> oneDnf;
+ * arma::uvec negatives;
+ * oneDnf.ReliableNegatives(positive, unlabeled, negatives);
+ * @endcode
+ *
+ * @tparam MatType Type of data; an Armadillo sparse matrix type.
+ */
+template<typename MatType = arma::sp_mat>
+class OneDNF
+{
+ public:
+  //! Create the technique; the positive features are found when training.
+  OneDNF() : numFeatures(0) { }
+
+  /**
+   * Find the positive features, then the reliable negatives among the
+   * unlabeled documents.
+   *
+   * @param positive Positive documents, one column per document.
+   * @param unlabeled Unlabeled documents, one column per document.
+   * @param negatives Set to the indices of the reliable negatives in
+   *     unlabeled, in increasing order.
+   */
+  void ReliableNegatives(const MatType& positive,
+                         const MatType& unlabeled,
+                         arma::uvec& negatives);
+
+  /**
+   * Find the positive features of the given documents.
+   *
+   * @param positive Positive documents, one column per document.
+   * @param unlabeled Unlabeled documents, one column per document.
+   */
+  void Train(const MatType& positive, const MatType& unlabeled);
+
+  /**
+   * Set each element of contains to 1 if the document contains a positive
+   * feature, and to 0 otherwise.
+   *
+   * @param data Documents, one column per document.
+   * @param contains This will be filled with one value per document.
+   */
+  void Classify(const MatType& data, arma::Row<size_t>& contains) const;
+
+  //! Get the indices of the positive features, in increasing order.
+  arma::uvec PositiveFeatures() const;
+
+  //! Get whether the given feature is positive.
+  bool IsPositive(const size_t feature) const
+  {
+    return (bits[feature / 64] >> (feature % 64)) & 1;
+  }
+
+  //! Serialize the positive features.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Number of features.
+  size_t numFeatures;
+  //! The positive features, one bit per feature.
+  std::vector<uint64_t> bits;
+};
+
+} // namespace pu
+} // namespace mlpack
+
+// Include implementation.
+#include "one_dnf_impl.hpp"
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file one_dnf_impl.hpp
+ *
+ * Implementation of the 1-DNF technique.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PU_LEARNING_ONE_DNF_IMPL_HPP
+#define MLPACK_METHODS_PU_LEARNING_ONE_DNF_IMPL_HPP
+
+// In case it hasn't been included already.
+#include "one_dnf.hpp"
+
+#include "document_frequencies.hpp"
+
+namespace mlpack {
+namespace pu {
+
+template<typename MatType>
+void OneDNF<MatType>::Train(const MatType& positive, const MatType& unlabeled)
+{
+  if (positive.n_rows != unlabeled.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "OneDNF::Train(): dimensionality of positive documents ("
+        << positive.n_rows << ") does not match that of unlabeled documents ("
+        << unlabeled.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  numFeatures = positive.n_rows;
+  arma::Col<size_t> positiveDf(numFeatures, arma::fill::zeros);
+  arma::Col<size_t> unlabeledDf(numFeatures, arma::fill::zeros);
+  DocumentFrequencies(positive, positiveDf);
+  DocumentFrequencies(unlabeled, unlabeledDf);
+
+  // Compare positiveDf / |P| > unlabeledDf / |U| without dividing.
+  bits.assign((numFeatures + 63) / 64, 0);
+  for (size_t i = 0; i < numFeatures; ++i)
+  {
+    if ((double) positiveDf[i] * unlabeled.n_cols >
+        (double) unlabeledDf[i] * positive.n_cols)
+      bits[i / 64] |= ((uint64_t) 1) << (i % 64);
+  }
+}
+
+template<typename MatType>
+void OneDNF<MatType>::Classify(const MatType& data,
+                               arma::Row<size_t>& contains) const
+{
+  if (data.n_rows != numFeatures)
+  {
+    std::ostringstream oss;
+    oss << "OneDNF::Classify(): dimensionality of data (" << data.n_rows
+        << ") does not match the model (" << numFeatures << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  contains.set_size(data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+  {
+    contains[j] = 0;
+    typename MatType::const_iterator it = data.begin_col(j);
+    for (; it != data.end_col(j); ++it)
+    {
+      if ((*it) != 0 && IsPositive(it.row()))
+      {
+        contains[j] = 1;
+        break;
+      }
+    }
+  }
+}
+
+template<typename MatType>
+void OneDNF<MatType>::ReliableNegatives(const MatType& positive,
+                                        const MatType& unlabeled,
+                                        arma::uvec& negatives)
+{
+  Train(positive, unlabeled);
+
+  arma::Row<size_t> contains;
+  Classify(unlabeled, contains);
+  negatives = arma::find(contains == 0);
+}
+
+template<typename MatType>
+arma::uvec OneDNF<MatType>::PositiveFeatures() const
+{
+  std::vector<arma::uword> features;
+  for (size_t i = 0; i < numFeatures; ++i)
+    if (IsPositive(i))
+      features.push_back(i);
+
+  return arma::uvec(features);
+}
+
+template<typename MatType>
+template<typename Archive>
+void OneDNF<MatType>::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(numFeatures);
+  ar & BOOST_SERIALIZATION_NVP(bits);
+}
+
+} // namespace pu
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file quantile_sketch.hpp
+ *
+ * A streaming quantile sketch, which estimates quantiles of a stream of values
+ * in memory logarithmic in the length of the stream.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PU_LEARNING_QUANTILE_SKETCH_HPP
+#define MLPACK_METHODS_PU_LEARNING_QUANTILE_SKETCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pu /** Learning from positive and unlabeled data. */ {
+
+/**
+ * A quantile sketch made of a hierarchy of compactors (Manku, Rajagopalan and
+ * Lindsay, 1998; Karnin, Lang and Liberty, 2016).  Values enter level 0; when a
+ * level holds capacity values, they are sorted and every other one moves up a
+ * level, where it stands for twice as many values.  The sketch thus keeps
+ * O(capacity * log(n / capacity)) values, and the rank of a quantile is off by
+ * O(n log(n / capacity) / capacity) at most.  Until capacity values have been
+ * inserted, quantiles are exact.
+ *
+ * Compactors alternate between keeping the even and the odd positions, so the
+ * sketch does not draw random numbers and may be used by several threads, one
+ * sketch each.
+ */
+class QuantileSketch
+{
+ public:
+  /**
+   * Create an empty sketch.
+   *
+   * @param capacity Number of values a level holds before it is compacted.
+   */
+  QuantileSketch(const size_t capacity = 256);
+
+  //! Insert a value.
+  void Insert(const double value);
+
+  /**
+   * Return an estimate of the q-quantile of the inserted values, that is, the
+   * smallest value with at least a fraction q of the values at or below it.
+   * An std::invalid_argument is thrown if the sketch is empty.
+   *
+   * @param q Fraction in [0, 1].
+   */
+  double Quantile(const double q) const;
+
+  //! Get the number of inserted values.
+  size_t Count() const { return count; }
+  //! Get the capacity of each level.
+  size_t Capacity() const { return capacity; }
+
+ private:
+  //! Number of values a level holds before it is compacted.
+  size_t capacity;
+  //! Number of inserted values.
+  size_t count;
+  //! Values of each level; a value of level h stands for 2^h values.
+  std::vector<std::vector<double>> levels;
+  //! Whether the next compaction of each level keeps the odd positions.
+  std::vector<bool> odd;
+
+  //! Move every other value of the given level up one level.
+  void Compact(const size_t level);
+};
+
+} // namespace pu
+} // namespace mlpack
+
+// Include implementation.
+#include "quantile_sketch_impl.hpp"
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file quantile_sketch_impl.hpp
+ *
+ * Implementation of the streaming quantile sketch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PU_LEARNING_QUANTILE_SKETCH_IMPL_HPP
+#define MLPACK_METHODS_PU_LEARNING_QUANTILE_SKETCH_IMPL_HPP
+
+// In case it hasn't been included already.
+#include "quantile_sketch.hpp"
+
+namespace mlpack {
+namespace pu {
+
+inline QuantileSketch::QuantileSketch(const size_t capacity) :
+    capacity(std::max(capacity, (size_t) 2)),
+    count(0),
+    levels(1),
+    odd(1, false)
+{
+  levels[0].reserve(this->capacity);
+}
+
+inline void QuantileSketch::Insert(const double value)
+{
+  levels[0].push_back(value);
+  ++count;
+  if (levels[0].size() >= capacity)
+    Compact(0);
+}
+
+inline void QuantileSketch::Compact(const size_t level)
+{
+  if (level + 1 == levels.size())
+  {
+    levels.emplace_back();
+    levels.back().reserve(capacity);
+    odd.push_back(false);
+  }
+
+  // An odd value out, the largest, stays on this level.
+  std::vector<double>& values = levels[level];
+  std::sort(values.begin(), values.end());
+  const size_t n = values.size() - values.size() % 2;
+  for (size_t i = odd[level] ? 1 : 0; i < n; i += 2)
+    levels[level + 1].push_back(values[i]);
+  odd[level] = !odd[level];
+  values.erase(values.begin(), values.begin() + n);
+
+  if (levels[level + 1].size() >= capacity)
+    Compact(level + 1);
+}
+
+inline double QuantileSketch::Quantile(const double q) const
+{
+  if (count == 0)
+  {
+    throw std::invalid_argument("QuantileSketch::Quantile(): no values have "
+        "been inserted!");
+  }
+
+  std::vector<std::pair<double, double>> weighted;
+  double total = 0;
+  for (size_t h = 0; h < levels.size(); ++h)
+  {
+    const double weight = std::ldexp(1.0, (int) h);
+    for (size_t i = 0; i < levels[h].size(); ++i)
+      weighted.push_back(std::make_pair(levels[h][i], weight));
+    total += weight * levels[h].size();
+  }
+  std::sort(weighted.begin(), weighted.end());
+
+  const double target = std::min(std::max(q, 0.0), 1.0) * total;
+  double rank = 0;
+  for (size_t i = 0; i < weighted.size(); ++i)
+  {
+    rank += weighted[i].second;
+    if (rank >= target)
+      return weighted[i].first;
+  }
+  return weighted.back().first;
+}
+
+} // namespace pu
+} // namespace mlpack
+
+#endif
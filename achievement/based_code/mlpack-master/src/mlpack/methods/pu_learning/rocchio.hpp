@@ -0,0 +1,171 @@
+/**
+ * @file rocchio.hpp
+ *
+ * The Rocchio classifier for learning from positive and unlabeled documents,
+ * which is also a reliable-negative stage.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PU_LEARNING_ROCCHIO_HPP
+#define MLPACK_METHODS_PU_LEARNING_ROCCHIO_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pu {
+
+/**
+ * The Rocchio classifier as used for learning from positive and unlabeled
+ * documents (Li and Liu, 2003).  Documents are term-frequency vectors weighted
+ * by the inverse document frequency over all training documents and normalized
+ * to unit length.  With the means p of the positive and u of the unlabeled
+ * documents, the prototypes of the two classes are
+ *
+ * c_1 = alpha * p - beta * u,
+ * c_0 = alpha * u - beta * p,
+ *
+ * and a document is predicted in the class of the prototype of highest cosine
+ * similarity.  As a reliable-negative stage (see Spy), the unlabeled documents
+ * closer to c_0 are the reliable negatives.
+ *
+ * Training is one pass over the nonzero elements for the document frequencies
+ * and one for the means; each thread sums into its own dense vector.  The
+ * prototypes and their norms are computed once, and stored transposed so that
+ * the prototype values of a term are contiguous.  Documents are then scored in
+ * parallel, each by one pass over its nonzero elements.
+ *
+ * @code
+ * extern arma::sp_mat positive, unlabeled; // Term frequencies.
+ * Rocchio<> rocchio;
+ * arma::uvec negatives;
+ * rocchio.ReliableNegatives(positive, unlabeled, negatives);
+ * @endcode
+ *
+ * @tparam MatType Type of data; an Armadillo sparse matrix type.
+ */
+template<typename MatType = arma::sp_mat>
+class Rocchio
+{
+ public:
+  // Convenience typedef.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Create the classifier without training it.
+   *
+   * @param alpha Weight of the mean of the documents of a class.
+   * @param beta Weight of the mean of the documents of the other class.
+   * @param useIdf Whether to weight terms by inverse document frequency.
+   */
+  Rocchio(const double alpha = 16.0,
+          const double beta = 4.0,
+          const bool useIdf = true);
+
+  /**
+   * Create the classifier and train it.
+   *
+   * @param positive Positive documents, one column per document.
+   * @param unlabeled Unlabeled documents, one column per document.
+   * @param alpha Weight of the mean of the documents of a class.
+   * @param beta Weight of the mean of the documents of the other class.
+   * @param useIdf Whether to weight terms by inverse document frequency.
+   */
+  Rocchio(const MatType& positive,
+          const MatType& unlabeled,
+          const double alpha = 16.0,
+          const double beta = 4.0,
+          const bool useIdf = true);
+
+  /**
+   * Compute the prototypes of positive and unlabeled documents.
+   *
+   * @param positive Positive documents, one column per document.
+   * @param unlabeled Unlabeled documents, one column per document.
+   */
+  void Train(const MatType& positive, const MatType& unlabeled);
+
+  /**
+   * Predict the class of each document: 1 if it is closer to the positive
+   * prototype, 0 otherwise.
+   *
+   * @param data Documents to classify, one column per document.
+   * @param predictions This will be filled with predictions.
+   */
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the class of each document, and also return the cosine
+   * similarity of each document to the prototype of each class.
+   *
+   * @param data Documents to classify, one column per document.
+   * @param predictions This will be filled with predictions.
+   * @param similarities This will be filled with the cosine similarities to
+   *     the prototypes of classes 0 and 1; each column is a document.
+   */
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& similarities) const;
+
+  /**
+   * Train on the given documents and find the reliable negatives among the
+   * unlabeled ones.
+   *
+   * @param positive Positive documents, one column per document.
+   * @param unlabeled Unlabeled documents, one column per document.
+   * @param negatives Set to the indices of the reliable negatives in
+   *     unlabeled, in increasing order.
+   */
+  void ReliableNegatives(const MatType& positive,
+                         const MatType& unlabeled,
+                         arma::uvec& negatives);
+
+  //! Get the prototypes of classes 0 and 1 (2 x d).
+  const arma::mat& Prototypes() const { return prototypes; }
+  //! Get the inverse document frequency of each term.
+  const arma::vec& Idf() const { return idf; }
+
+  //! Get the weight of the mean of the documents of a class.
+  double Alpha() const { return alpha; }
+  //! Modify the weight of the mean of the documents of a class.
+  double& Alpha() { return alpha; }
+  //! Get the weight of the mean of the documents of the other class.
+  double Beta() const { return beta; }
+  //! Modify the weight of the mean of the documents of the other class.
+  double& Beta() { return beta; }
+  //! Get whether terms are weighted by inverse document frequency.
+  bool UseIdf() const { return useIdf; }
+  //! Modify whether terms are weighted by inverse document frequency.
+  bool& UseIdf() { return useIdf; }
+
+  //! Serialize the classifier.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Weight of the mean of the documents of a class.
+  double alpha;
+  //! Weight of the mean of the documents of the other class.
+  double beta;
+  //! Whether terms are weighted by inverse document frequency.
+  bool useIdf;
+  //! Inverse document frequency of each term (all ones without idf).
+  arma::vec idf;
+  //! Prototypes of classes 0 and 1, one column per term.
+  arma::mat prototypes;
+  //! Norms of the prototypes.
+  arma::vec prototypeNorms;
+
+  //! Add the mean of the weighted, normalized documents to mean.
+  void AddMean(const MatType& data, arma::vec& mean) const;
+};
+
+} // namespace pu
+} // namespace mlpack
+
+// Include implementation.
+#include "rocchio_impl.hpp"
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * @file rocchio_impl.hpp
+ *
+ * Implementation of the Rocchio classifier.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PU_LEARNING_ROCCHIO_IMPL_HPP
+#define MLPACK_METHODS_PU_LEARNING_ROCCHIO_IMPL_HPP
+
+// In case it hasn't been included already.
+#include "rocchio.hpp"
+
+#include "document_frequencies.hpp"
+
+namespace mlpack {
+namespace pu {
+
+template<typename MatType>
+Rocchio<MatType>::Rocchio(const double alpha,
+                          const double beta,
+                          const bool useIdf) :
+    alpha(alpha),
+    beta(beta),
+    useIdf(useIdf)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+Rocchio<MatType>::Rocchio(const MatType& positive,
+                          const MatType& unlabeled,
+                          const double alpha,
+                          const double beta,
+                          const bool useIdf) :
+    alpha(alpha),
+    beta(beta),
+    useIdf(useIdf)
+{
+  Train(positive, unlabeled);
+}
+
+template<typename MatType>
+void Rocchio<MatType>::AddMean(const MatType& data, arma::vec& mean) const
+{
+  #pragma omp parallel
+  {
+    arma::vec localSum(mean.n_elem, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      double norm = 0;
+      typename MatType::const_iterator it = data.begin_col(j);
+      for (; it != data.end_col(j); ++it)
+      {
+        const double v = (*it) * idf[it.row()];
+        norm += v * v;
+      }
+      if (norm == 0)
+        continue;
+
+      norm = std::sqrt(norm) * data.n_cols;
+      for (it = data.begin_col(j); it != data.end_col(j); ++it)
+        localSum[it.row()] += (*it) * idf[it.row()] / norm;
+    }
+
+    #pragma omp critical
+    {
+      mean += localSum;
+    }
+  }
+}
+
+template<typename MatType>
+void Rocchio<MatType>::Train(const MatType& positive,
+                             const MatType& unlabeled)
+{
+  if (positive.n_rows != unlabeled.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "Rocchio::Train(): dimensionality of positive documents ("
+        << positive.n_rows << ") does not match that of unlabeled documents ("
+        << unlabeled.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t numTerms = positive.n_rows;
+  idf.ones(numTerms);
+  if (useIdf)
+  {
+    arma::Col<size_t> df(numTerms, arma::fill::zeros);
+    DocumentFrequencies(positive, df);
+    DocumentFrequencies(unlabeled, df);
+
+    const double numDocuments = positive.n_cols + unlabeled.n_cols;
+    for (size_t i = 0; i < numTerms; ++i)
+      idf[i] = (df[i] > 0) ? std::log(numDocuments / df[i]) : 0;
+  }
+
+  arma::vec p(numTerms, arma::fill::zeros);
+  arma::vec u(numTerms, arma::fill::zeros);
+  AddMean(positive, p);
+  AddMean(unlabeled, u);
+
+  prototypes.set_size(2, numTerms);
+  prototypes.row(0) = (alpha * u - beta * p).t();
+  prototypes.row(1) = (alpha * p - beta * u).t();
+  prototypeNorms.set_size(2);
+  prototypeNorms[0] = arma::norm(prototypes.row(0));
+  prototypeNorms[1] = arma::norm(prototypes.row(1));
+}
+
+template<typename MatType>
+void Rocchio<MatType>::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions) const
+{
+  arma::mat similarities;
+  Classify(data, predictions, similarities);
+}
+
+template<typename MatType>
+void Rocchio<MatType>::Classify(const MatType& data,
+                                arma::Row<size_t>& predictions,
+                                arma::mat& similarities) const
+{
+  if (data.n_rows != idf.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "Rocchio::Classify(): dimensionality of data (" << data.n_rows
+        << ") does not match the model (" << idf.n_elem << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  predictions.set_size(data.n_cols);
+  similarities.set_size(2, data.n_cols);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+  {
+    double dot0 = 0, dot1 = 0, norm = 0;
+    typename MatType::const_iterator it = data.begin_col(j);
+    for (; it != data.end_col(j); ++it)
+    {
+      const double v = (*it) * idf[it.row()];
+      const double* c = prototypes.colptr(it.row());
+      dot0 += v * c[0];
+      dot1 += v * c[1];
+      norm += v * v;
+    }
+
+    norm = std::sqrt(norm);
+    similarities(0, j) = (norm > 0 && prototypeNorms[0] > 0) ?
+        dot0 / (norm * prototypeNorms[0]) : 0;
+    similarities(1, j) = (norm > 0 && prototypeNorms[1] > 0) ?
+        dot1 / (norm * prototypeNorms[1]) : 0;
+    predictions[j] = (similarities(1, j) > similarities(0, j)) ? 1 : 0;
+  }
+}
+
+template<typename MatType>
+void Rocchio<MatType>::ReliableNegatives(const MatType& positive,
+                                         const MatType& unlabeled,
+                                         arma::uvec& negatives)
+{
+  Train(positive, unlabeled);
+
+  arma::Row<size_t> predictions;
+  Classify(unlabeled, predictions);
+  negatives = arma::find(predictions == 0);
+}
+
+template<typename MatType>
+template<typename Archive>
+void Rocchio<MatType>::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(alpha);
+  ar & BOOST_SERIALIZATION_NVP(beta);
+  ar & BOOST_SERIALIZATION_NVP(useIdf);
+  ar & BOOST_SERIALIZATION_NVP(idf);
+  ar & BOOST_SERIALIZATION_NVP(prototypes);
+  ar & BOOST_SERIALIZATION_NVP(prototypeNorms);
+}
+
+} // namespace pu
+} // namespace mlpack
+
+#endif
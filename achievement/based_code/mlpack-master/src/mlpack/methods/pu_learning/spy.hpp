@@ -0,0 +1,166 @@
+/**
+ * @file spy.hpp
+ *
+ * The spy technique, which extracts reliable negatives from unlabeled data by
+ * hiding some positives among the unlabeled points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PU_LEARNING_SPY_HPP
+#define MLPACK_METHODS_PU_LEARNING_SPY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "classifier_traits.hpp"
+
+namespace mlpack {
+namespace pu {
+
+/**
+ * The spy technique of S-EM (Liu et al., 2002).  A fraction of the positives,
+ * the spies, is added to the unlabeled points, and a classifier is trained to
+ * separate the remaining positives from the unlabeled points and the spies.
+ * As the spies behave like the unknown positives among the unlabeled points,
+ * the threshold t is set so that a fraction noiseLevel of the spies have a
+ * posterior probability of the positive class below t, and the unlabeled
+ * points with a posterior below t are taken as reliable negatives.
+ *
+ * Spy is a reliable-negative stage of a two-step PU learner.  Such stages
+ * provide
+ *
+ * @code
+ * template<typename MatType>
+ * void ReliableNegatives(const MatType& positive,
+ *                        const MatType& unlabeled,
+ *                        arma::uvec& negatives);
+ * @endcode
+ *
+ * which sets negatives to the increasing indices of the columns of unlabeled
+ * that are reliable negatives.
+ *
+ * Any classifier with a default constructor and a method
+ * Classify(data, predictions, probabilities) that fills an arma::mat with one
+ * column of class probabilities per point may be used, such as
+ * NaiveBayesClassifier, MultinomialNaiveBayes or RandomForest.  It is trained
+ * on positives labeled 1 and the rest labeled 0 by the given training
+ * function; by default, Train(data, labels, 2) is called.  The positives and
+ * the unlabeled points are copied once into one training matrix shared by all
+ * draws; the unlabeled points are then scored in chunks of chunkSize columns,
+ * so the scores of the whole pool are never held in memory, and the threshold
+ * is estimated by a QuantileSketch.
+ *
+ * With numDraws > 1, spies are drawn numDraws times independently and a point
+ * is a reliable negative if it is below the threshold in more than half of the
+ * draws.  The spies of all draws are drawn beforehand.  When mlpack is
+ * compiled with OpenMP, draws are run in parallel if
+ * ClassifierTraits<ClassifierType>::DeterministicTraining is true, as for the
+ * Naive Bayes classifiers; otherwise training may draw from the random number
+ * generator of mlpack, which is not thread-safe, so draws are run one after
+ * another.
+ *
+ * @code
+ * extern arma::mat positive, unlabeled;
+ * Spy<naive_bayes::NaiveBayesClassifier<>> spy;
+ * arma::uvec negatives;
+ * spy.ReliableNegatives(positive, unlabeled, negatives);
+ * @endcode
+ *
+ * @tparam ClassifierType Type of classifier to train.
+ * @tparam MatType Type of data.
+ */
+template<typename ClassifierType, typename MatType = arma::mat>
+class Spy
+{
+ public:
+  //! The type of the function that trains a classifier on data and labels.
+  typedef std::function<void(ClassifierType&,
+                             const MatType&,
+                             const arma::Row<size_t>&)> TrainFunction;
+
+  /**
+   * Create the spy technique with the given parameters.
+   *
+   * @param spyRatio Fraction of the positives used as spies.
+   * @param noiseLevel Fraction of the spies allowed below the threshold.
+   * @param numDraws Number of independent draws of spies.
+   * @param chunkSize Number of points scored at a time.
+   * @param train Function that trains a classifier.
+   */
+  Spy(const double spyRatio = 0.15,
+      const double noiseLevel = 0.15,
+      const size_t numDraws = 1,
+      const size_t chunkSize = 10000,
+      const TrainFunction& train = DefaultTrain);
+
+  /**
+   * Find the reliable negatives among the unlabeled points.
+   *
+   * @param positive Positive points, one column per point.
+   * @param unlabeled Unlabeled points, one column per point.
+   * @param negatives Set to the indices of the reliable negatives in
+   *     unlabeled, in increasing order.
+   */
+  void ReliableNegatives(const MatType& positive,
+                         const MatType& unlabeled,
+                         arma::uvec& negatives) const;
+
+  //! Get the fraction of the positives used as spies.
+  double SpyRatio() const { return spyRatio; }
+  //! Modify the fraction of the positives used as spies.
+  double& SpyRatio() { return spyRatio; }
+
+  //! Get the fraction of the spies allowed below the threshold.
+  double NoiseLevel() const { return noiseLevel; }
+  //! Modify the fraction of the spies allowed below the threshold.
+  double& NoiseLevel() { return noiseLevel; }
+
+  //! Get the number of draws of spies.
+  size_t NumDraws() const { return numDraws; }
+  //! Modify the number of draws of spies.
+  size_t& NumDraws() { return numDraws; }
+
+  //! Get the number of points scored at a time.
+  size_t ChunkSize() const { return chunkSize; }
+  //! Modify the number of points scored at a time.
+  size_t& ChunkSize() { return chunkSize; }
+
+  //! Train the classifier with Train(data, labels, 2).
+  static void DefaultTrain(ClassifierType& classifier,
+                           const MatType& data,
+                           const arma::Row<size_t>& labels)
+  {
+    classifier.Train(data, labels, 2);
+  }
+
+ private:
+  //! Fraction of the positives used as spies.
+  double spyRatio;
+  //! Fraction of the spies allowed below the threshold.
+  double noiseLevel;
+  //! Number of draws of spies.
+  size_t numDraws;
+  //! Number of points scored at a time.
+  size_t chunkSize;
+  //! Function that trains a classifier.
+  TrainFunction train;
+
+  /**
+   * Call f(i, score) with the probability of the positive class of each
+   * column i of data, chunkSize columns at a time.
+   */
+  template<typename FunctionType>
+  void Score(const ClassifierType& classifier,
+             const MatType& data,
+             FunctionType f) const;
+};
+
+} // namespace pu
+} // namespace mlpack
+
+// Include implementation.
+#include "spy_impl.hpp"
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file spy_impl.hpp
+ *
+ * Implementation of the spy technique.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PU_LEARNING_SPY_IMPL_HPP
+#define MLPACK_METHODS_PU_LEARNING_SPY_IMPL_HPP
+
+// In case it hasn't been included already.
+#include "spy.hpp"
+
+#include "quantile_sketch.hpp"
+
+namespace mlpack {
+namespace pu {
+
+template<typename ClassifierType, typename MatType>
+Spy<ClassifierType, MatType>::Spy(const double spyRatio,
+                                  const double noiseLevel,
+                                  const size_t numDraws,
+                                  const size_t chunkSize,
+                                  const TrainFunction& train) :
+    spyRatio(spyRatio),
+    noiseLevel(noiseLevel),
+    numDraws(numDraws),
+    chunkSize(chunkSize),
+    train(train)
+{
+  // Nothing to do.
+}
+
+template<typename ClassifierType, typename MatType>
+template<typename FunctionType>
+void Spy<ClassifierType, MatType>::Score(const ClassifierType& classifier,
+                                         const MatType& data,
+                                         FunctionType f) const
+{
+  const size_t step = std::max(chunkSize, (size_t) 1);
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  for (size_t begin = 0; begin < data.n_cols; begin += step)
+  {
+    const size_t end = std::min(begin + step, (size_t) data.n_cols) - 1;
+    const MatType chunk = data.cols(begin, end);
+    classifier.Classify(chunk, predictions, probabilities);
+    for (size_t i = 0; i < chunk.n_cols; ++i)
+      f(begin + i, probabilities(1, i));
+  }
+}
+
+template<typename ClassifierType, typename MatType>
+void Spy<ClassifierType, MatType>::ReliableNegatives(
+    const MatType& positive,
+    const MatType& unlabeled,
+    arma::uvec& negatives) const
+{
+  if (positive.n_cols < 2)
+  {
+    throw std::invalid_argument("Spy::ReliableNegatives(): at least two "
+        "positive points are needed!");
+  }
+  if (positive.n_rows != unlabeled.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "Spy::ReliableNegatives(): dimensionality of positive points ("
+        << positive.n_rows << ") does not match that of unlabeled points ("
+        << unlabeled.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Positives come first; spies are only positives labeled 0, so all draws
+  // share the same training data.
+  const MatType data = arma::join_rows(positive, unlabeled);
+  const size_t numSpies = std::min(std::max((size_t) std::ceil(spyRatio *
+      positive.n_cols), (size_t) 1), (size_t) positive.n_cols - 1);
+
+  // Draw all spies here, as the random number generator is not thread-safe.
+  std::vector<arma::uvec> spies(numDraws);
+  for (size_t d = 0; d < numDraws; ++d)
+  {
+    const arma::uvec order = arma::randperm(positive.n_cols);
+    spies[d] = arma::sort(order.head(numSpies));
+  }
+
+  arma::Col<size_t> votes(unlabeled.n_cols, arma::fill::zeros);
+  const bool parallel = ClassifierTraits<ClassifierType>::DeterministicTraining;
+  #pragma omp parallel for schedule(dynamic) if(parallel)
+  for (omp_size_t d = 0; d < (omp_size_t) numDraws; ++d)
+  {
+    arma::Row<size_t> labels(data.n_cols, arma::fill::zeros);
+    labels.cols(0, positive.n_cols - 1).fill(1);
+    labels.elem(spies[d]).zeros();
+
+    ClassifierType classifier;
+    train(classifier, data, labels);
+
+    // Spies are scored with the other positives, which are few.
+    QuantileSketch sketch;
+    size_t s = 0;
+    Score(classifier, positive, [&](const size_t i, const double score)
+    {
+      if (s < numSpies && spies[d][s] == i)
+      {
+        sketch.Insert(score);
+        ++s;
+      }
+    });
+    const double threshold = sketch.Quantile(noiseLevel);
+
+    Score(classifier, unlabeled, [&](const size_t i, const double score)
+    {
+      if (score < threshold)
+      {
+        #pragma omp atomic
+        ++votes[i];
+      }
+    });
+  }
+
+  negatives = arma::find(votes * 2 > numDraws);
+}
+
+} // namespace pu
+} // namespace mlpack
+
+#endif
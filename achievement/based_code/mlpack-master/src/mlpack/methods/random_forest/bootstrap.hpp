@@ -18,6 +18,7 @@ namespace tree {
 
 /**
  * Given a dataset, create another dataset via bootstrap sampling, with labels.
+ * This copies the sampled points; RandomForest uses BootstrapIndices() instead.
  */
 template<bool UseWeights,
          typename MatType,
@@ -47,6 +48,47 @@ void Bootstrap(const MatType& dataset,
   }
 }
 
+/**
+ * Draw a bootstrap sample of numPoints points as indices, so that the dataset
+ * itself need not be copied: indices holds numPoints indices drawn with
+ * replacement, in increasing order so that the columns of the dataset are
+ * visited in memory order, and outOfBag holds the indices of the points that
+ * were not drawn, in increasing order.  The draws come from the given
+ * generator only, so samples can be drawn in parallel from generators seeded
+ * in advance.
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param indices Set to the indices of the bootstrap sample.
+ * @param outOfBag Set to the indices of the points not in the sample.
+ * @param rng Random number generator to draw from.
+ */
+inline void BootstrapIndices(const size_t numPoints,
+                             arma::uvec& indices,
+                             arma::uvec& outOfBag,
+                             std::mt19937& rng)
+{
+  // Draw the number of times each point is sampled, then expand.
+  arma::Col<size_t> multiplicities(numPoints, arma::fill::zeros);
+  std::uniform_int_distribution<size_t> draw(0, numPoints - 1);
+  for (size_t i = 0; i < numPoints; ++i)
+    ++multiplicities[draw(rng)];
+
+  indices.set_size(numPoints);
+  size_t numOutOfBag = 0;
+  for (size_t i = 0, k = 0; i < numPoints; ++i)
+  {
+    for (size_t m = 0; m < multiplicities[i]; ++m)
+      indices[k++] = i;
+    if (multiplicities[i] == 0)
+      ++numOutOfBag;
+  }
+
+  outOfBag.set_size(numOutOfBag);
+  for (size_t i = 0, k = 0; i < numPoints; ++i)
+    if (multiplicities[i] == 0)
+      outOfBag[k++] = i;
+}
+
 } // namespace tree
 } // namespace mlpack
 
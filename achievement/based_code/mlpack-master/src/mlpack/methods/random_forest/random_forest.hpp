@@ -35,7 +35,7 @@ class RandomForest
    * Construct the random forest without any training or specifying the number
    * of trees.  Predict() will throw an exception until Train() is called.
    */
-  RandomForest() { }
+  RandomForest() : oobError(0.0) { }
 
   /**
    * Create a random forest, training on the given labeled training data with
@@ -257,6 +257,14 @@ class RandomForest
   //! Get the number of trees in the forest.
   size_t NumTrees() const { return trees.size(); }
 
+  /**
+   * Get the out-of-bag error of the last training: the fraction of the points
+   * misclassified by the trees whose bootstrap samples did not contain them,
+   * over the points that were left out by at least one tree.  This is not
+   * saved with the model.
+   */
+  double OOBError() const { return oobError; }
+
   /**
    * Serialize the random forest.
    */
@@ -291,6 +299,8 @@ class RandomForest
 
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
+  //! The out-of-bag error of the last training.
+  double oobError;
 };
 
 } // namespace tree
@@ -432,41 +432,73 @@ void RandomForest<
   // Train each tree individually.
   trees.resize(numTrees); // This will fill the vector with untrained trees.
 
+  // The class probabilities of each point summed over the trees for which it
+  // is out of bag.
+  arma::mat oobProbabilities(numClasses, dataset.n_cols, arma::fill::zeros);
+  double* oobSums = oobProbabilities.memptr();
+
+  // The global random number generator is not thread-safe, so only the seed
+  // of each tree is drawn from it, serially; the bootstrap sample of a tree
+  // is then drawn in the loop from its own generator, which also keeps the
+  // samples independent of the number of threads.
+  std::vector<uint32_t> seeds(numTrees);
+  for (size_t i = 0; i < numTrees; ++i)
+    seeds[i] = (uint32_t) math::randGen();
+
   #pragma omp parallel for
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
-    MatType bootstrapDataset;
-    arma::Row<size_t> bootstrapLabels;
+    // Each tree sees the dataset through its bootstrap indices, so only the
+    // labels and weights are copied.
+    std::mt19937 rng(seeds[i]);
+    arma::uvec indices, outOfBag;
+    BootstrapIndices(dataset.n_cols, indices, outOfBag, rng);
+    arma::Row<size_t> bootstrapLabels = labels.cols(indices);
     arma::rowvec bootstrapWeights;
-    Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-        bootstrapLabels, bootstrapWeights);
+    if (UseWeights)
+      bootstrapWeights = weights.cols(indices);
 
     // Now build the decision tree.
-    if (UseWeights)
+    if (UseDatasetInfo)
     {
-      if (UseDatasetInfo)
-      {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses, weights,
-            minimumLeafSize);
-      }
-      else
-      {
-        trees[i].Train(dataset, labels, numClasses, weights, minimumLeafSize);
-      }
+      trees[i].template Train<UseWeights>(dataset, indices, 0, indices.n_elem,
+          datasetInfo, bootstrapLabels, numClasses, bootstrapWeights,
+          minimumLeafSize);
     }
     else
     {
-      if (UseDatasetInfo)
-      {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses,
-            minimumLeafSize);
-      }
-      else
+      trees[i].template Train<UseWeights>(dataset, indices, 0, indices.n_elem,
+          bootstrapLabels, numClasses, bootstrapWeights, minimumLeafSize);
+    }
+
+    // Let the tree vote for the points it has not seen.
+    arma::vec probabilities;
+    size_t prediction; // Ignored.
+    for (size_t j = 0; j < outOfBag.n_elem; ++j)
+    {
+      trees[i].Classify(dataset.col(outOfBag[j]), prediction, probabilities);
+      for (size_t c = 0; c < probabilities.n_elem; ++c)
       {
-        trees[i].Train(dataset, labels, numClasses, minimumLeafSize);
+        #pragma omp atomic
+        oobSums[outOfBag[j] * numClasses + c] += probabilities[c];
       }
     }
   }
+
+  size_t numOutOfBag = 0, numMisclassified = 0;
+  for (size_t j = 0; j < dataset.n_cols; ++j)
+  {
+    if (arma::accu(oobProbabilities.col(j)) == 0.0)
+      continue;
+
+    arma::uword maxIndex = 0;
+    oobProbabilities.col(j).max(maxIndex);
+    ++numOutOfBag;
+    if ((size_t) maxIndex != labels[j])
+      ++numMisclassified;
+  }
+  oobError = (numOutOfBag == 0) ? 0.0 :
+      (double) numMisclassified / (double) numOutOfBag;
 }
 
 } // namespace tree
@@ -11,7 +11,11 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include <mlpack/methods/decision_tree/c45_tree.hpp>
+#include <mlpack/methods/decision_tree/positive_only_statistics.hpp>
 #include <mlpack/methods/decision_tree/information_gain.hpp>
+#include <mlpack/methods/decision_tree/feature_binning.hpp>
+#include <mlpack/methods/decision_tree/histogram_numeric_split.hpp>
 #include <mlpack/methods/decision_tree/gini_gain.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
@@ -367,6 +371,220 @@ BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Evaluating the fitness functions from class counts should give the same
+ * result as evaluating them from the labels.
+ */
+BOOST_AUTO_TEST_CASE(FitnessFunctionEvaluatePtrTest)
+{
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(1000,
+      arma::distr_param(0, 4));
+  arma::rowvec weights = arma::randu<arma::rowvec>(1000);
+
+  arma::vec counts(5, arma::fill::zeros);
+  arma::vec weightSums(5, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    counts[labels[i]]++;
+    weightSums[labels[i]] += weights[i];
+  }
+
+  BOOST_REQUIRE_CLOSE(GiniGain::EvaluatePtr(counts.memptr(), 5,
+      (double) labels.n_elem), GiniGain::Evaluate<false>(labels, 5, weights),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(GiniGain::EvaluatePtr(weightSums.memptr(), 5,
+      arma::accu(weights)), GiniGain::Evaluate<true>(labels, 5, weights),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(InformationGain::EvaluatePtr(counts.memptr(), 5,
+      (double) labels.n_elem), InformationGain::Evaluate<false>(labels, 5,
+      weights), 1e-5);
+  BOOST_REQUIRE_CLOSE(InformationGain::EvaluatePtr(weightSums.memptr(), 5,
+      arma::accu(weights)), InformationGain::Evaluate<true>(labels, 5,
+      weights), 1e-5);
+  BOOST_REQUIRE_EQUAL(GiniGain::EvaluatePtr(counts.memptr(), 5, 0.0), 0.0);
+}
+
+/**
+ * The best split found by BestBinaryNumericSplit should be the best split found
+ * by evaluating every prefix of the sorted points.
+ */
+BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitExhaustiveTest)
+{
+  arma::vec values = arma::round(10 * arma::randu<arma::vec>(200));
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = (values[i] + 3 * math::Random() > 6.5) ? 1 : 0;
+  arma::rowvec weights = arma::randu<arma::rowvec>(200);
+
+  const arma::uvec sortedIndices = arma::sort_index(values);
+  const arma::Row<size_t> sortedLabels = labels.cols(sortedIndices);
+  const arma::rowvec sortedWeights = weights.cols(sortedIndices);
+  const double totalWeight = arma::accu(weights);
+
+  double bestGain = -DBL_MAX, bestWeightedGain = -DBL_MAX;
+  for (size_t index = 5; index <= 195; ++index)
+  {
+    if (values[sortedIndices[index]] == values[sortedIndices[index - 1]])
+      continue;
+
+    const double leftRatio = index / 200.0;
+    const double gain = leftRatio * GiniGain::Evaluate<false>(
+        sortedLabels.subvec(0, index - 1), 2, weights) + (1 - leftRatio) *
+        GiniGain::Evaluate<false>(sortedLabels.subvec(index, 199), 2, weights);
+    bestGain = std::max(bestGain, gain);
+
+    const double leftWeight = arma::accu(sortedWeights.subvec(0, index - 1));
+    const double weightedGain = (leftWeight / totalWeight) *
+        GiniGain::Evaluate<true>(sortedLabels.subvec(0, index - 1), 2,
+        sortedWeights.subvec(0, index - 1)) +
+        ((totalWeight - leftWeight) / totalWeight) *
+        GiniGain::Evaluate<true>(sortedLabels.subvec(index, 199), 2,
+        sortedWeights.subvec(index, 199));
+    bestWeightedGain = std::max(bestWeightedGain, weightedGain);
+  }
+
+  arma::vec classProbabilities;
+  BestBinaryNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      -DBL_MAX, values, labels, 2, weights, 5, 0.0, classProbabilities, aux);
+  const double weightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(-DBL_MAX, values,
+      labels, 2, weights, 5, 0.0, classProbabilities, aux);
+
+  BOOST_REQUIRE_CLOSE(gain, bestGain, 1e-5);
+  BOOST_REQUIRE_CLOSE(weightedGain, bestWeightedGain, 1e-5);
+}
+
+/**
+ * Dimensions with few values get one bin per value, and dimensions with many
+ * values get bins of about equal size.
+ */
+BOOST_AUTO_TEST_CASE(FeatureBinningTest)
+{
+  arma::mat data(2, 10000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    data(0, i) = (double) (i % 7);
+    data(1, i) = math::Random();
+  }
+
+  FeatureBinning binning(64);
+  binning.Fit(data);
+  arma::Mat<unsigned char> binned;
+  binning.Transform(data, binned);
+
+  BOOST_REQUIRE_EQUAL(binned.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(binned.n_cols, 10000);
+  BOOST_REQUIRE_EQUAL(binning.NumBins(0), 7);
+  BOOST_REQUIRE_EQUAL(binning.NumBins(1), 64);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL((size_t) binned(0, i), i % 7);
+
+  // Bins keep the order of values, and hold about 10000 / 64 points each.
+  arma::Col<size_t> binCounts(64, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    ++binCounts[binned(1, i)];
+    if (binned(1, i) > 0)
+      BOOST_REQUIRE_GT(data(1, i), binning.Cuts(1)[binned(1, i) - 1]);
+    if (binned(1, i) < 63)
+      BOOST_REQUIRE_LE(data(1, i), binning.Cuts(1)[binned(1, i)]);
+  }
+  BOOST_REQUIRE_GT(binCounts.min(), 140);
+  BOOST_REQUIRE_LT(binCounts.max(), 175);
+
+  BOOST_REQUIRE_THROW(FeatureBinning(257), std::invalid_argument);
+}
+
+/**
+ * On binned data, the HistogramNumericSplit should find the same gain as the
+ * BestBinaryNumericSplit.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitTest)
+{
+  arma::Row<unsigned char> bins(1000);
+  arma::Row<size_t> labels(1000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    bins[i] = (unsigned char) math::RandInt(256);
+    labels[i] = (bins[i] + 60 * math::Random() > 150) ? 1 : 0;
+  }
+  const arma::rowvec values = arma::conv_to<arma::rowvec>::from(bins);
+
+  arma::vec classProbabilities, histogramClassProbabilities;
+  BestBinaryNumericSplit<GiniGain>::AuxiliarySplitInfo<double> aux;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo<double> histogramAux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 5, 0.0, classProbabilities, aux);
+  const double histogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, bins,
+      labels, 2, weights, 5, 0.0, histogramClassProbabilities, histogramAux);
+
+  BOOST_REQUIRE_GT(histogramGain, bestGain);
+  BOOST_REQUIRE_CLOSE(histogramGain, gain, 1e-5);
+  BOOST_REQUIRE_EQUAL(histogramClassProbabilities.n_elem, 1);
+
+  // Every point goes to the same side as with the exact split.
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(HistogramNumericSplit<GiniGain>::CalculateDirection(
+        values[i], histogramClassProbabilities, histogramAux),
+        BestBinaryNumericSplit<GiniGain>::CalculateDirection(values[i],
+        classProbabilities, aux));
+  }
+
+  // With weights, too.
+  const double weightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 5, 0.0, classProbabilities, aux);
+  const double histogramWeightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, bins,
+      labels, 2, weights, 5, 0.0, histogramClassProbabilities, histogramAux);
+  BOOST_REQUIRE_CLOSE(histogramWeightedGain, weightedGain, 1e-5);
+}
+
+/**
+ * A decision tree trained on binned data should generalize like one trained on
+ * the original data.
+ */
+BOOST_AUTO_TEST_CASE(HistogramDecisionTreeTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Row<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  FeatureBinning binning;
+  binning.Fit(inputData);
+  arma::Mat<unsigned char> binnedData, binnedTestData;
+  binning.Transform(inputData, binnedData);
+  binning.Transform(testData, binnedTestData);
+
+  DecisionTree<GiniGain, HistogramNumericSplit> d(binnedData, labels, 3, 10);
+
+  arma::Row<size_t> predictions;
+  d.Classify(binnedTestData, predictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+
+  const double correct = arma::accu(predictions == trueTestLabels) /
+      (double) predictions.n_elem;
+  BOOST_REQUIRE_GT(correct, 0.75);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -1126,4 +1344,252 @@ BOOST_AUTO_TEST_CASE(RegularisedDecisionTree)
   BOOST_REQUIRE_GT(count, 0);
 }
 
+/**
+ * Count the nodes of a C4.5 tree.
+ */
+template<typename TreeType>
+size_t CountC45Nodes(const TreeType& tree)
+{
+  size_t count = 1;
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    count += CountC45Nodes(tree.Child(i));
+  return count;
+}
+
+/**
+ * The C4.5 tree should generalize on the vc2 dataset.
+ */
+BOOST_AUTO_TEST_CASE(C45GeneralizationTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Row<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  C45Tree<> tree(inputData, labels, 3);
+  BOOST_REQUIRE_EQUAL(tree.NumClasses(), 3);
+  BOOST_REQUIRE_GT(tree.NumChildren(), 0);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  tree.Classify(testData, predictions, probabilities);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 3);
+
+  double correct = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+    BOOST_REQUIRE_EQUAL(predictions[i], tree.Classify(testData.col(i)));
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+  }
+  correct /= predictions.n_elem;
+
+  BOOST_REQUIRE_GT(correct, 0.75);
+}
+
+/**
+ * A categorical dimension that determines the label should give a multiway
+ * split with one child per category.
+ */
+BOOST_AUTO_TEST_CASE(C45CategoricalSplitTest)
+{
+  data::DatasetInfo info(2);
+  info.MapString<double>("a", 0);
+  info.MapString<double>("b", 0);
+  info.MapString<double>("c", 0);
+  info.Type(0) = data::Datatype::categorical;
+
+  arma::mat dataset(2, 600);
+  arma::Row<size_t> labels(600);
+  for (size_t i = 0; i < 600; ++i)
+  {
+    dataset(0, i) = i % 3;
+    dataset(1, i) = math::Random();
+    labels[i] = (i % 3 == 2) ? 1 : 0;
+  }
+
+  C45Tree<> tree(dataset, info, labels, 2);
+  BOOST_REQUIRE_EQUAL(tree.SplitDimension(), 0);
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), 3);
+  for (size_t c = 0; c < 3; ++c)
+  {
+    BOOST_REQUIRE_EQUAL(tree.Child(c).NumChildren(), 0);
+    BOOST_REQUIRE_CLOSE(tree.BranchWeights()[c], 1.0 / 3.0, 1e-5);
+  }
+
+  arma::vec point("2 0.5");
+  BOOST_REQUIRE_EQUAL(tree.Classify(point), 1);
+  point[0] = 1;
+  BOOST_REQUIRE_EQUAL(tree.Classify(point), 0);
+}
+
+/**
+ * Points of missing value go down all children, in training and in
+ * classification.
+ */
+BOOST_AUTO_TEST_CASE(C45MissingValuesTest)
+{
+  // The second dimension is constant, so it cannot be split on.
+  arma::mat dataset(2, 1000, arma::fill::zeros);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    dataset(0, i) = (double) i / 1000.0;
+    labels[i] = (i < 250) ? 1 : 0;
+  }
+
+  // Hide the split value of a fifth of the points.
+  for (size_t i = 0; i < 1000; i += 5)
+    dataset(0, i) = arma::datum::nan;
+
+  C45Tree<> tree(dataset, labels, 2);
+  BOOST_REQUIRE_EQUAL(tree.SplitDimension(), 0);
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), 2);
+  BOOST_REQUIRE_CLOSE(tree.BranchWeights()[0], 0.25, 1e-5);
+  BOOST_REQUIRE_CLOSE(tree.BranchWeights()[1], 0.75, 1e-5);
+
+  // The children hold their points and a share of the missing ones.
+  BOOST_REQUIRE_CLOSE(tree.Child(0).TotalWeight(), 200.0 + 0.25 * 200.0,
+      1e-5);
+  BOOST_REQUIRE_CLOSE(tree.Child(1).TotalWeight(), 600.0 + 0.75 * 200.0,
+      1e-5);
+
+  // A point of missing value gets the mix of both children.
+  arma::vec point(2);
+  point[0] = arma::datum::nan;
+  point[1] = 0.0;
+  size_t prediction;
+  arma::vec probabilities;
+  tree.Classify(point, prediction, probabilities);
+  BOOST_REQUIRE_EQUAL(prediction, 0);
+  BOOST_REQUIRE_CLOSE(probabilities[1], 0.25 *
+      tree.Child(0).ClassProbabilities()[1] + 0.75 *
+      tree.Child(1).ClassProbabilities()[1], 1e-5);
+
+  point[0] = 0.1;
+  BOOST_REQUIRE_EQUAL(tree.Classify(point), 1);
+}
+
+/**
+ * The added errors should match C4.5, and pruning should shrink a tree grown
+ * on noisy labels.
+ */
+BOOST_AUTO_TEST_CASE(C45PruningTest)
+{
+  // No errors out of 6 points: 6 * (1 - 0.25^(1/6)).
+  BOOST_REQUIRE_CLOSE(C45Tree<>::AddedErrors(6.0, 0.0, 0.25), 1.237797, 1e-3);
+  BOOST_REQUIRE_GT(C45Tree<>::AddedErrors(100.0, 10.0, 0.1),
+      C45Tree<>::AddedErrors(100.0, 10.0, 0.25));
+  BOOST_REQUIRE_GT(C45Tree<>::AddedErrors(100.0, 10.0, 0.25), 0.0);
+
+  arma::mat dataset(2, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    labels[i] = (dataset(0, i) > 0.5) ? 1 : 0;
+    if (math::Random() < 0.2)
+      labels[i] = 1 - labels[i];
+  }
+
+  C45Tree<> unpruned(dataset, labels, 2, 2, 1.0);
+  C45Tree<> pruned(dataset, labels, 2, 2, 0.25);
+  const size_t unprunedNodes = CountC45Nodes(unpruned);
+  const size_t prunedNodes = CountC45Nodes(pruned);
+  BOOST_REQUIRE_LT(prunedNodes, unprunedNodes);
+
+  // Pruning the unpruned tree gives the same tree.
+  unpruned.Prune(0.25);
+  BOOST_REQUIRE_EQUAL(CountC45Nodes(unpruned), prunedNodes);
+
+  // The pruned tree should still find the split.
+  arma::mat testData(2, 1000, arma::fill::randu);
+  arma::Row<size_t> predictions;
+  pruned.Classify(testData, predictions);
+  double correct = 0.0;
+  for (size_t i = 0; i < 1000; ++i)
+    if (predictions[i] == ((testData(0, i) > 0.5) ? 1 : 0))
+      ++correct;
+  BOOST_REQUIRE_GT(correct / 1000.0, 0.9);
+}
+
+/**
+ * POSC4.5 should find the hidden positives among the unlabeled points from
+ * the positives and the prior.
+ */
+BOOST_AUTO_TEST_CASE(POSC45Test)
+{
+  PositiveOnlyStatistics statistics(0.25);
+  arma::vec labelCounts("800 200");
+  statistics.Initialize(labelCounts);
+  arma::vec classCounts;
+  statistics.ClassCounts(arma::vec("100 50"), classCounts);
+  BOOST_REQUIRE_CLOSE(classCounts[0], 50.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(classCounts[1], 50.0, 1e-5);
+  statistics.ClassCounts(arma::vec("0 10"), classCounts);
+  BOOST_REQUIRE_SMALL(classCounts[0], 1e-5);
+  BOOST_REQUIRE_CLOSE(classCounts[1], 10.0, 1e-5);
+
+  // 200 positives; 800 unlabeled points, of which 200 are positives.
+  arma::mat dataset = arma::join_rows(arma::randn<arma::mat>(3, 400) + 2,
+      arma::randn<arma::mat>(3, 600) - 2);
+  arma::Row<size_t> labels(1000, arma::fill::zeros);
+  labels.subvec(0, 199).fill(1);
+
+  C45Tree<InformationGain, AllCategoricalSplit, PositiveOnlyStatistics> tree(
+      dataset, labels, 2, 2, 0.25, statistics);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset.cols(200, 999), predictions);
+  size_t correct = 0;
+  for (size_t i = 0; i < 800; ++i)
+    if (predictions[i] == ((i < 200) ? 1 : 0))
+      ++correct;
+  BOOST_REQUIRE_GT(correct, 760);
+}
+
+/**
+ * Make sure a C4.5 tree serializes and copies correctly.
+ */
+BOOST_AUTO_TEST_CASE(C45SerializationTest)
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  C45Tree<> tree(dataset, labels, 3);
+  C45Tree<> xmlTree, textTree, binaryTree;
+  SerializeObjectAll(tree, xmlTree, textTree, binaryTree);
+  C45Tree<> copy(tree);
+
+  arma::Row<size_t> predictions, xmlPredictions, textPredictions,
+      binaryPredictions, copyPredictions;
+  tree.Classify(dataset, predictions);
+  xmlTree.Classify(dataset, xmlPredictions);
+  textTree.Classify(dataset, textPredictions);
+  binaryTree.Classify(dataset, binaryPredictions);
+  copy.Classify(dataset, copyPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(predictions, copyPredictions);
+  BOOST_REQUIRE_EQUAL(CountC45Nodes(tree), CountC45Nodes(xmlTree));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
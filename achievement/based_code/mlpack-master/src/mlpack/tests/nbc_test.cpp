@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/naive_bayes/naive_bayes_classifier.hpp>
+#include <mlpack/methods/naive_bayes/multinomial_naive_bayes.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -314,4 +315,141 @@ BOOST_AUTO_TEST_CASE(SeparateTrainIndividualIncrementalTest)
   }
 }
 
+/**
+ * Check the multinomial model against values computed by hand on a tiny
+ * dataset.
+ */
+BOOST_AUTO_TEST_CASE(MultinomialNaiveBayesSimpleTest)
+{
+  // Three features; two points of class 0 and one of class 1.
+  arma::mat data("2 1 0;"
+                 "0 1 0;"
+                 "0 0 3");
+  arma::Row<size_t> labels("0 0 1");
+
+  MultinomialNaiveBayes<> nb(arma::sp_mat(data), labels, 2);
+
+  // Class 0 has counts (3, 1, 0) and class 1 (0, 0, 3), smoothed by 1.
+  BOOST_REQUIRE_CLOSE(nb.LogProbabilities()(0, 0), std::log(4.0 / 7.0), 1e-5);
+  BOOST_REQUIRE_CLOSE(nb.LogProbabilities()(0, 1), std::log(2.0 / 7.0), 1e-5);
+  BOOST_REQUIRE_CLOSE(nb.LogProbabilities()(0, 2), std::log(1.0 / 7.0), 1e-5);
+  BOOST_REQUIRE_CLOSE(nb.LogProbabilities()(1, 0), std::log(1.0 / 6.0), 1e-5);
+  BOOST_REQUIRE_CLOSE(nb.LogProbabilities()(1, 1), std::log(1.0 / 6.0), 1e-5);
+  BOOST_REQUIRE_CLOSE(nb.LogProbabilities()(1, 2), std::log(4.0 / 6.0), 1e-5);
+  BOOST_REQUIRE_CLOSE(nb.LogPriors()[0], std::log(2.0 / 3.0), 1e-5);
+  BOOST_REQUIRE_CLOSE(nb.LogPriors()[1], std::log(1.0 / 3.0), 1e-5);
+
+  arma::vec point("1 0 0");
+  BOOST_REQUIRE_EQUAL(nb.Classify(point), 0);
+  point = arma::vec("0 0 1");
+  BOOST_REQUIRE_EQUAL(nb.Classify(point), 1);
+}
+
+/**
+ * Sparse and dense data must give the same model and predictions, and the
+ * probabilities of very long documents must not underflow.
+ */
+BOOST_AUTO_TEST_CASE(MultinomialNaiveBayesSparseDenseTest)
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(1000, 500, 0.02);
+  sparseData *= 10;
+  arma::mat denseData(sparseData);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(500,
+      arma::distr_param(0, 2));
+
+  MultinomialNaiveBayes<> sparseNb(sparseData, labels, 3);
+  MultinomialNaiveBayes<> denseNb(denseData, labels, 3);
+
+  for (size_t i = 0; i < sparseNb.LogProbabilities().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sparseNb.LogProbabilities()[i],
+        denseNb.LogProbabilities()[i], 1e-5);
+
+  arma::Row<size_t> sparsePredictions, densePredictions;
+  arma::mat probabilities;
+  sparseNb.Classify(sparseData * 1000, sparsePredictions, probabilities);
+  denseNb.Classify(denseData * 1000, densePredictions);
+
+  for (size_t i = 0; i < sparsePredictions.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(sparsePredictions[i], densePredictions[i]);
+    BOOST_REQUIRE_CLOSE(arma::accu(probabilities.col(i)), 1.0, 1e-5);
+    BOOST_REQUIRE_CLOSE(probabilities(sparsePredictions[i], i),
+        arma::max(probabilities.col(i)), 1e-5);
+  }
+}
+
+/**
+ * Training with one-hot responsibilities must give the model of hard labels.
+ */
+BOOST_AUTO_TEST_CASE(MultinomialNaiveBayesSoftLabelTest)
+{
+  arma::sp_mat data;
+  data.sprandu(200, 300, 0.05);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(300,
+      arma::distr_param(0, 1));
+  arma::mat responsibilities(2, 300, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    responsibilities(labels[i], i) = 1;
+
+  MultinomialNaiveBayes<> hardNb(data, labels, 2);
+  MultinomialNaiveBayes<> softNb;
+  softNb.Train(data, responsibilities);
+
+  for (size_t i = 0; i < hardNb.LogProbabilities().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(hardNb.LogProbabilities()[i],
+        softNb.LogProbabilities()[i], 1e-5);
+  for (size_t i = 0; i < 2; ++i)
+    BOOST_REQUIRE_CLOSE(hardNb.LogPriors()[i], softNb.LogPriors()[i], 1e-5);
+}
+
+/**
+ * Training on responsibilities for a different number of points should throw.
+ */
+BOOST_AUTO_TEST_CASE(MultinomialNaiveBayesResponsibilitiesSizeTest)
+{
+  arma::sp_mat data = arma::sprandu<arma::sp_mat>(20, 10, 0.3);
+  arma::mat responsibilities(2, 9, arma::fill::ones);
+
+  MultinomialNaiveBayes<> nb;
+  BOOST_REQUIRE_THROW(nb.Train(data, responsibilities), std::invalid_argument);
+}
+
+/**
+ * Documents of two topics with only a few labeled: EM over the unlabeled
+ * documents should classify nearly all of them correctly.
+ */
+BOOST_AUTO_TEST_CASE(MultinomialNaiveBayesEMTest)
+{
+  math::RandomSeed(42);
+
+  // Topic c draws its words from features [50c, 50c + 50) with probability
+  // 0.7, and from all 100 features otherwise.
+  const size_t n = 400;
+  arma::mat data(100, n, arma::fill::zeros);
+  arma::Row<size_t> labels(n);
+  for (size_t j = 0; j < n; ++j)
+  {
+    labels[j] = j % 2;
+    for (size_t w = 0; w < 30; ++w)
+    {
+      if (math::Random() < 0.7)
+        data(50 * labels[j] + math::RandInt(50), j) += 1;
+      else
+        data(math::RandInt(100), j) += 1;
+    }
+  }
+  arma::sp_mat labeled(data.cols(0, 9));
+  arma::sp_mat unlabeled(data.cols(10, n - 1));
+
+  MultinomialNaiveBayes<> nb(labeled, labels.cols(0, 9), 2);
+  const double logLikelihood = nb.EM(labeled, labels.cols(0, 9), unlabeled);
+  BOOST_REQUIRE(std::isfinite(logLikelihood));
+
+  arma::Row<size_t> predictions;
+  nb.Classify(unlabeled, predictions);
+  const size_t emCorrect = arma::accu(predictions == labels.cols(10, n - 1));
+  BOOST_REQUIRE_GT(emCorrect, 0.95 * (n - 10));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,237 @@
+/**
+ * @file pu_learning_test.cpp
+ *
+ * Tests for the components of learning from positive and unlabeled data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/pu_learning/one_dnf.hpp>
+#include <mlpack/methods/pu_learning/quantile_sketch.hpp>
+#include <mlpack/methods/pu_learning/rocchio.hpp>
+#include <mlpack/methods/pu_learning/spy.hpp>
+#include <mlpack/methods/naive_bayes/naive_bayes_classifier.hpp>
+#include <mlpack/methods/naive_bayes/multinomial_naive_bayes.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::pu;
+using namespace mlpack::naive_bayes;
+
+BOOST_AUTO_TEST_SUITE(PULearningTest);
+
+/**
+ * Create a Gaussian PU dataset: numPositive labeled positives around +2, and
+ * unlabeled points of which the first numHidden are positives and the rest
+ * negatives around -2.
+ */
+void GaussianPUData(const size_t numPositive,
+                    const size_t numHidden,
+                    const size_t numNegative,
+                    arma::mat& positive,
+                    arma::mat& unlabeled)
+{
+  positive = arma::randn<arma::mat>(5, numPositive) + 2;
+  unlabeled = arma::join_rows(arma::randn<arma::mat>(5, numHidden) + 2,
+      arma::randn<arma::mat>(5, numNegative) - 2);
+}
+
+/**
+ * Create a sparse two-topic PU dataset of word counts: the first numHidden
+ * unlabeled documents are positives, the rest negatives.  Each word is drawn
+ * from all features with probability noise, and from the topic of the
+ * document otherwise.
+ */
+void TopicPUData(const size_t numPositive,
+                 const size_t numHidden,
+                 const size_t numNegative,
+                 arma::sp_mat& positive,
+                 arma::sp_mat& unlabeled,
+                 const double noise = 0.2)
+{
+  const size_t n = numPositive + numHidden + numNegative;
+  arma::mat data(200, n, arma::fill::zeros);
+  for (size_t j = 0; j < n; ++j)
+  {
+    // Positives draw from features [0, 100), negatives from [100, 200).
+    const size_t offset = (j < numPositive + numHidden) ? 0 : 100;
+    for (size_t w = 0; w < 20; ++w)
+    {
+      if (math::Random() >= noise)
+        data(offset + math::RandInt(100), j) += 1;
+      else
+        data(math::RandInt(200), j) += 1;
+    }
+  }
+  positive = arma::sp_mat(data.cols(0, numPositive - 1));
+  unlabeled = arma::sp_mat(data.cols(numPositive, n - 1));
+}
+
+/**
+ * Quantiles of few values are exact.
+ */
+BOOST_AUTO_TEST_CASE(QuantileSketchExactTest)
+{
+  QuantileSketch sketch;
+  for (size_t i = 100; i > 0; --i)
+    sketch.Insert((double) i);
+
+  BOOST_REQUIRE_EQUAL(sketch.Count(), 100);
+  BOOST_REQUIRE_EQUAL(sketch.Quantile(0.0), 1.0);
+  BOOST_REQUIRE_EQUAL(sketch.Quantile(0.15), 15.0);
+  BOOST_REQUIRE_EQUAL(sketch.Quantile(0.5), 50.0);
+  BOOST_REQUIRE_EQUAL(sketch.Quantile(1.0), 100.0);
+}
+
+/**
+ * Quantiles of many values are close.
+ */
+BOOST_AUTO_TEST_CASE(QuantileSketchStreamTest)
+{
+  QuantileSketch sketch;
+  for (size_t i = 0; i < 200000; ++i)
+    sketch.Insert(math::Random());
+
+  BOOST_REQUIRE_EQUAL(sketch.Count(), 200000);
+  BOOST_REQUIRE_SMALL(sketch.Quantile(0.05) - 0.05, 0.01);
+  BOOST_REQUIRE_SMALL(sketch.Quantile(0.5) - 0.5, 0.01);
+  BOOST_REQUIRE_SMALL(sketch.Quantile(0.9) - 0.9, 0.01);
+}
+
+/**
+ * The spy technique with a Gaussian Naive Bayes classifier should find most
+ * negatives and few hidden positives.
+ */
+BOOST_AUTO_TEST_CASE(SpyNaiveBayesTest)
+{
+  math::RandomSeed(42);
+
+  arma::mat positive, unlabeled;
+  GaussianPUData(300, 200, 500, positive, unlabeled);
+
+  // Small chunks, so that scoring goes over several of them.
+  Spy<NaiveBayesClassifier<>> spy(0.15, 0.15, 1, 64);
+  arma::uvec negatives;
+  spy.ReliableNegatives(positive, unlabeled, negatives);
+
+  const size_t numHidden = arma::accu(negatives < 200);
+  BOOST_REQUIRE_GT(negatives.n_elem, 400);
+  BOOST_REQUIRE_LT(numHidden, 10);
+  for (size_t i = 1; i < negatives.n_elem; ++i)
+    BOOST_REQUIRE_LT(negatives[i - 1], negatives[i]);
+}
+
+/**
+ * The spy technique with several draws on sparse documents and the
+ * multinomial Naive Bayes classifier.
+ */
+BOOST_AUTO_TEST_CASE(SpyMultinomialDrawsTest)
+{
+  math::RandomSeed(42);
+
+  arma::sp_mat positive, unlabeled;
+  TopicPUData(200, 100, 300, positive, unlabeled);
+
+  Spy<MultinomialNaiveBayes<>, arma::sp_mat> spy(0.2, 0.1, 5);
+  arma::uvec negatives;
+  spy.ReliableNegatives(positive, unlabeled, negatives);
+
+  const size_t numHidden = arma::accu(negatives < 100);
+  BOOST_REQUIRE_GT(negatives.n_elem, 250);
+  BOOST_REQUIRE_LT(numHidden, 5);
+}
+
+/**
+ * Rocchio should take most negatives and few hidden positives as reliable
+ * negatives.
+ */
+BOOST_AUTO_TEST_CASE(RocchioReliableNegativesTest)
+{
+  arma::sp_mat positive, unlabeled;
+  TopicPUData(200, 100, 300, positive, unlabeled);
+
+  Rocchio<> rocchio;
+  arma::uvec negatives;
+  rocchio.ReliableNegatives(positive, unlabeled, negatives);
+
+  const size_t numHidden = arma::accu(negatives < 100);
+  BOOST_REQUIRE_GT(negatives.n_elem, 250);
+  BOOST_REQUIRE_LT(numHidden, 5);
+}
+
+/**
+ * Similarities are cosines, predictions follow them, and documents that are
+ * prototypes themselves have similarity one.
+ */
+BOOST_AUTO_TEST_CASE(RocchioSimilarityTest)
+{
+  arma::sp_mat positive, unlabeled;
+  TopicPUData(100, 50, 150, positive, unlabeled);
+
+  Rocchio<> rocchio(positive, unlabeled, 1.0, 0.0, false);
+  arma::Row<size_t> predictions;
+  arma::mat similarities;
+  rocchio.Classify(unlabeled, predictions, similarities);
+
+  BOOST_REQUIRE_EQUAL(similarities.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(similarities.n_cols, unlabeled.n_cols);
+  for (size_t i = 0; i < unlabeled.n_cols; ++i)
+  {
+    BOOST_REQUIRE_LE(std::abs(similarities(0, i)), 1.0 + 1e-10);
+    BOOST_REQUIRE_LE(std::abs(similarities(1, i)), 1.0 + 1e-10);
+    BOOST_REQUIRE_EQUAL(predictions[i],
+        (similarities(1, i) > similarities(0, i)) ? 1 : 0);
+  }
+
+  // Without idf and beta, the positive prototype is the mean of the
+  // normalized positives.
+  arma::sp_mat prototype(rocchio.Prototypes().row(1).t());
+  rocchio.Classify(prototype, predictions, similarities);
+  BOOST_REQUIRE_CLOSE(similarities(1, 0), 1.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(predictions[0], 1);
+}
+
+/**
+ * 1-DNF should select the features of the positive topic and take the
+ * documents without them as reliable negatives.
+ */
+BOOST_AUTO_TEST_CASE(OneDNFReliableNegativesTest)
+{
+  // Each word of a negative is from the positive topic with probability 0.02,
+  // so about two thirds of the negatives have none.
+  arma::sp_mat positive, unlabeled;
+  TopicPUData(200, 100, 300, positive, unlabeled, 0.04);
+
+  OneDNF<> oneDnf;
+  arma::uvec negatives;
+  oneDnf.ReliableNegatives(positive, unlabeled, negatives);
+
+  const arma::uvec features = oneDnf.PositiveFeatures();
+  BOOST_REQUIRE_GT(features.n_elem, 90);
+  BOOST_REQUIRE_LT(arma::accu(features >= 100), 10);
+  for (size_t i = 0; i < features.n_elem; ++i)
+    BOOST_REQUIRE(oneDnf.IsPositive(features[i]));
+
+  // The reliable negatives are the documents without a positive feature.
+  arma::Row<size_t> contains;
+  oneDnf.Classify(unlabeled, contains);
+  BOOST_REQUIRE_EQUAL(negatives.n_elem, arma::accu(contains == 0));
+  for (size_t i = 1; i < negatives.n_elem; ++i)
+    BOOST_REQUIRE_LT(negatives[i - 1], negatives[i]);
+
+  // Against the true labels (the first 100 unlabeled documents are hidden
+  // positives), they are almost all negatives and most negatives are found.
+  BOOST_REQUIRE_GT(negatives.n_elem, 0);
+  const double trueNegatives = arma::accu(negatives >= 100);
+  const double precision = trueNegatives / negatives.n_elem;
+  const double recall = trueNegatives / 300;
+  BOOST_REQUIRE_GT(precision, 0.98);
+  BOOST_REQUIRE_GT(recall, 0.5);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
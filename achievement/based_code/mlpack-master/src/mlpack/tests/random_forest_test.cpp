@@ -12,6 +12,8 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
+#include <mlpack/methods/decision_tree/feature_binning.hpp>
+#include <mlpack/methods/decision_tree/histogram_numeric_split.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -96,6 +98,69 @@ BOOST_AUTO_TEST_CASE(BootstrapWeightsTest)
   }
 }
 
+/**
+ * Bootstrap indices should be sorted, and the out-of-bag indices should be
+ * exactly the points that were not drawn.  The same seed gives the same
+ * sample.
+ */
+BOOST_AUTO_TEST_CASE(BootstrapIndicesTest)
+{
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    std::mt19937 rng(trial);
+    arma::uvec indices, outOfBag;
+    BootstrapIndices(1000, indices, outOfBag, rng);
+
+    std::mt19937 sameRng(trial);
+    arma::uvec sameIndices, sameOutOfBag;
+    BootstrapIndices(1000, sameIndices, sameOutOfBag, sameRng);
+    BOOST_REQUIRE_EQUAL(arma::accu(indices != sameIndices), 0);
+    BOOST_REQUIRE_EQUAL(arma::accu(outOfBag != sameOutOfBag), 0);
+
+    BOOST_REQUIRE_EQUAL(indices.n_elem, 1000);
+    for (size_t i = 1; i < indices.n_elem; ++i)
+      BOOST_REQUIRE_LE(indices[i - 1], indices[i]);
+    BOOST_REQUIRE_LT(indices[indices.n_elem - 1], 1000);
+
+    arma::Col<size_t> drawn(1000, arma::fill::zeros);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      drawn[indices[i]] = 1;
+    BOOST_REQUIRE_EQUAL(outOfBag.n_elem, 1000 - arma::accu(drawn));
+    for (size_t i = 0; i < outOfBag.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(drawn[outOfBag[i]], 0);
+
+    // About a third of the points are out of bag.
+    BOOST_REQUIRE_GT(outOfBag.n_elem, 300);
+    BOOST_REQUIRE_LT(outOfBag.n_elem, 440);
+  }
+}
+
+/**
+ * The out-of-bag error should be close to the test error.
+ */
+BOOST_AUTO_TEST_CASE(OOBErrorTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 5);
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testDataset, predictions);
+  const double testError = 1.0 - arma::accu(predictions == testLabels) /
+      (double) testDataset.n_cols;
+
+  BOOST_REQUIRE_GT(rf.OOBError(), 0.0);
+  BOOST_REQUIRE_LT(rf.OOBError(), 0.35);
+  BOOST_REQUIRE_SMALL(rf.OOBError() - testError, 0.15);
+}
+
 /**
  * Make sure an empty forest cannot predict.
  */
@@ -153,6 +218,38 @@ BOOST_AUTO_TEST_CASE(UnweightedNumericLearningTest)
   BOOST_REQUIRE_GE(rfCorrect, size_t(0.7 * testDataset.n_cols));
 }
 
+/**
+ * Test learning on binned data with histogram splits.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericLearningTest)
+{
+  // Load the vc2 dataset.
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  // Quantize the training and test data the same way.
+  FeatureBinning binning;
+  binning.Fit(dataset);
+  arma::Mat<unsigned char> binnedDataset, binnedTestDataset;
+  binning.Transform(dataset, binnedDataset);
+  binning.Transform(testDataset, binnedTestDataset);
+
+  RandomForest<GiniGain, RandomDimensionSelect, HistogramNumericSplit> rf(
+      binnedDataset, labels, 3, 10 /* 10 trees */, 5);
+
+  arma::Row<size_t> rfPredictions;
+  rf.Classify(binnedTestDataset, rfPredictions);
+
+  const size_t rfCorrect = arma::accu(rfPredictions == testLabels);
+  BOOST_REQUIRE_GE(rfCorrect, size_t(0.7 * testDataset.n_cols));
+}
+
 /**
  * Test weighted numeric learning, making sure that we get better performance
  * than a single decision tree.